@@ -42,7 +42,9 @@
 
 #define esp_nn_fully_connected_s8 esp_nn_fully_connected_s8_ansi
 #define esp_nn_fully_connected_per_ch_s8 esp_nn_fully_connected_per_ch_s8_ansi
+#define esp_nn_fully_connected_batch_s8 esp_nn_fully_connected_batch_s8_ansi
 
 #define esp_nn_get_softmax_scratch_size esp_nn_get_softmax_scratch_size_ansi
 #define esp_nn_set_softmax_scratch_buf esp_nn_set_softmax_scratch_buf_ansi
+#define esp_nn_prepare_softmax_s8 esp_nn_prepare_softmax_s8_ansi
 #define esp_nn_softmax_s8 esp_nn_softmax_s8_ansi
@@ -220,6 +220,28 @@ void esp_nn_fully_connected_per_ch_s8_ansi(const int8_t *input_data,
                                     const int32_t activation_min,
                                     const int32_t activation_max);
 
+/**
+ * @brief       fully connected over a batch of input rows
+ *
+ * @note        input_data is batches x row_len, out_data is
+ *              batches x out_channels. Same as calling
+ *              esp_nn_fully_connected_s8 once per row.
+ */
+void esp_nn_fully_connected_batch_s8_ansi(const int8_t *input_data,
+                                          const int32_t input_offset,
+                                          const uint16_t row_len,
+                                          const uint16_t batches,
+                                          const int8_t *filter_data,
+                                          const int32_t filter_offset,
+                                          const int32_t *bias,
+                                          int8_t *out_data,
+                                          const uint16_t out_channels,
+                                          const int32_t out_offset,
+                                          const int32_t out_shift,
+                                          const int32_t out_mult,
+                                          const int32_t activation_min,
+                                          const int32_t activation_max);
+
 /**
  * @brief   Get scratch buffer size needed by softmax function
  *
@@ -242,6 +264,16 @@ int32_t esp_nn_get_softmax_scratch_size_opt(const int32_t width, const int32_t h
  */
 void esp_nn_set_softmax_scratch_buf_ansi(void *buffer);
 
+/**
+ * @brief   Prepare softmax for a given set of quantization parameters
+ *
+ * @note    Optional: builds whatever the softmax function can reuse across
+ *          calls with the same `mult`, `shift` and `diff_min`.
+ */
+void esp_nn_prepare_softmax_s8_ansi(const int32_t mult,
+                                    const int32_t shift,
+                                    const int32_t diff_min);
+
 /**
  * @brief       reference softmax function
  *
@@ -258,6 +290,51 @@ void esp_nn_softmax_s8_ansi(const int8_t *input_data,
 
 //////////////////////////// Generic optimisations /////////////////////////////
 
+/************************** Basic math functions ****************************/
+
+/**
+ * @brief       elementwise addition optimized version
+ *
+ * @note        bit-exact with `esp_nn_add_elementwise_s8_ansi`. When either
+ *              input holds a single value throughout, the output is looked up
+ *              in a 256-entry table.
+ */
+void esp_nn_add_elementwise_s8_opt(const int8_t *input1_data,
+                                   const int8_t *input2_data,
+                                   const int32_t input1_offset,
+                                   const int32_t input2_offset,
+                                   const int32_t input1_mult,
+                                   const int32_t input2_mult,
+                                   const int32_t input1_shift,
+                                   const int32_t input2_shift,
+                                   const int32_t left_shift,
+                                   int8_t *output,
+                                   const int32_t out_offset,
+                                   const int32_t out_mult,
+                                   const int32_t out_shift,
+                                   const int32_t activation_min,
+                                   const int32_t activation_max,
+                                   const int32_t size);
+
+/**
+ * @brief       elementwise multiplication optimized version
+ *
+ * @note        bit-exact with `esp_nn_mul_elementwise_s8_ansi`. When either
+ *              input holds a single value throughout, the output is looked up
+ *              in a 256-entry table.
+ */
+void esp_nn_mul_elementwise_s8_opt(const int8_t *input1_data,
+                                   const int8_t *input2_data,
+                                   const int32_t input1_offset,
+                                   const int32_t input2_offset,
+                                   int8_t *output,
+                                   const int32_t out_offset,
+                                   const int32_t out_mult,
+                                   const int32_t out_shift,
+                                   const int32_t activation_min,
+                                   const int32_t activation_max,
+                                   const int32_t size);
+
 /************************** Convolution functions *****************************/
 
 /**
@@ -312,14 +389,138 @@ int esp_nn_get_depthwise_conv_scratch_size_opt(const data_dims_t *input_dims,
                                                const dw_conv_params_t *conv_params);
 void esp_nn_set_depthwise_conv_scratch_buf_opt(const void *buf);
 
+/************************** Pooling functions *****************************/
+
+/**
+ * @brief       avg_pool optimized version
+ *
+ * @note        running window sums instead of re-summing every window, and
+ *              reciprocal multiplies instead of divides, bit-exact with
+ *              `esp_nn_avg_pool_s8_ansi`
+ */
+void esp_nn_avg_pool_s8_opt(const int8_t *input,
+                            const uint16_t input_wd,
+                            const uint16_t input_ht,
+                            int8_t *output,
+                            const uint16_t output_wd,
+                            const uint16_t output_ht,
+                            const uint16_t stride_wd,
+                            const uint16_t stride_ht,
+                            const uint16_t filter_wd,
+                            const uint16_t filter_ht,
+                            const uint16_t pad_wd,
+                            const uint16_t pad_ht,
+                            const int32_t activation_min,
+                            const int32_t activation_max,
+                            const uint16_t channels);
+
+/**
+ * @brief       max_pool optimized version
+ *
+ * @note        four channels per 32 bit word; channels must be a multiple of 4
+ *              and input/output 4 byte aligned, else the ANSI C version is used
+ */
+void esp_nn_max_pool_s8_opt(const int8_t *input,
+                            const uint16_t input_wd,
+                            const uint16_t input_ht,
+                            int8_t *output,
+                            const uint16_t output_wd,
+                            const uint16_t output_ht,
+                            const uint16_t stride_wd,
+                            const uint16_t stride_ht,
+                            const uint16_t filter_wd,
+                            const uint16_t filter_ht,
+                            const uint16_t pad_wd,
+                            const uint16_t pad_ht,
+                            const int32_t activation_min,
+                            const int32_t activation_max,
+                            const uint16_t channels);
+
+/************************** Fully connected functions *************************/
+
+/**
+ * @brief       fully connected optimized version
+ *
+ * @note        offset cross-terms are folded into a per-call constant and
+ *              four output channels are computed per pass over the input.
+ *              Bit-exact with esp_nn_fully_connected_s8_ansi.
+ */
+void esp_nn_fully_connected_s8_opt(const int8_t *input_data,
+                                   const int32_t input_offset,
+                                   const uint16_t row_len,
+                                   const int8_t *filter_data,
+                                   const int32_t filter_offset,
+                                   const int32_t *bias,
+                                   int8_t *out_data,
+                                   const uint16_t out_channels,
+                                   const int32_t out_offset,
+                                   const int32_t out_shift,
+                                   const int32_t out_mult,
+                                   const int32_t activation_min,
+                                   const int32_t activation_max);
+
+/**
+ * @brief       fully connected per channel optimized version
+ *
+ * @note        per out_channel shift and multiplier, otherwise as
+ *              esp_nn_fully_connected_s8_opt
+ */
+void esp_nn_fully_connected_per_ch_s8_opt(const int8_t *input_data,
+                                          const int32_t input_offset,
+                                          const uint16_t row_len,
+                                          const int8_t *filter_data,
+                                          const int32_t filter_offset,
+                                          const int32_t *bias,
+                                          int8_t *out_data,
+                                          const uint16_t out_channels,
+                                          const int32_t out_offset,
+                                          const int32_t *out_shift,
+                                          const int32_t *out_mult,
+                                          const int32_t activation_min,
+                                          const int32_t activation_max);
+
+/**
+ * @brief       fully connected over a batch of input rows, optimized version
+ *
+ * @note        runs esp_nn_fully_connected_s8_opt on each row.
+ *              Bit-exact with esp_nn_fully_connected_batch_s8_ansi.
+ */
+void esp_nn_fully_connected_batch_s8_opt(const int8_t *input_data,
+                                         const int32_t input_offset,
+                                         const uint16_t row_len,
+                                         const uint16_t batches,
+                                         const int8_t *filter_data,
+                                         const int32_t filter_offset,
+                                         const int32_t *bias,
+                                         int8_t *out_data,
+                                         const uint16_t out_channels,
+                                         const int32_t out_offset,
+                                         const int32_t out_shift,
+                                         const int32_t out_mult,
+                                         const int32_t activation_min,
+                                         const int32_t activation_max);
+
 /* ANSI C function to be hooked up when optimised version needed */
 void esp_nn_set_softmax_scratch_buf_opt(void *buffer);
 
+/**
+ * @brief       build the 256-entry exp table for `mult`, `shift` and `diff_min`
+ *
+ * @note        the table is a static of the kernel, not scratch. It is kept
+ *              until the softmax function is called with other parameters,
+ *              in which case it is rebuilt, so calling this is optional.
+ *              Not safe to run concurrently with another softmax call.
+ */
+void esp_nn_prepare_softmax_s8_opt(const int32_t mult,
+                                   const int32_t shift,
+                                   const int32_t diff_min);
+
 /**
  * @brief       optimised version of softmax function
  *
- * @note        the function uses extra buffer (4 * width bytes)
- *              hence, scratch buffers must be set before calling this.
+ * @note        the exp lookup table is kernel owned (1024 bytes of static
+ *              RAM), no scratch buffer is needed. See
+ *              `esp_nn_prepare_softmax_s8_opt`.
  */
 void esp_nn_softmax_s8_opt(const int8_t *input_data,
                            const int32_t height,
@@ -42,8 +42,8 @@ void esp_nn_set_conv_scratch_buf_esp32p4(const void *buf);
 
 
 
-#define esp_nn_add_elementwise_s8 esp_nn_add_elementwise_s8_ansi
-#define esp_nn_mul_elementwise_s8 esp_nn_mul_elementwise_s8_ansi
+#define esp_nn_add_elementwise_s8 esp_nn_add_elementwise_s8_opt
+#define esp_nn_mul_elementwise_s8 esp_nn_mul_elementwise_s8_opt
 
 #define esp_nn_depthwise_conv_s8 esp_nn_depthwise_conv_s8_opt
 
@@ -57,12 +57,14 @@ void esp_nn_set_conv_scratch_buf_esp32p4(const void *buf);
 
 #define esp_nn_relu6_s8 esp_nn_relu6_s8_ansi
 
-#define esp_nn_avg_pool_s8 esp_nn_avg_pool_s8_ansi
-#define esp_nn_max_pool_s8 esp_nn_max_pool_s8_ansi
+#define esp_nn_avg_pool_s8 esp_nn_avg_pool_s8_opt
+#define esp_nn_max_pool_s8 esp_nn_max_pool_s8_opt
 
-#define esp_nn_fully_connected_s8 esp_nn_fully_connected_s8_ansi
-#define esp_nn_fully_connected_per_ch_s8 esp_nn_fully_connected_per_ch_s8_ansi
+#define esp_nn_fully_connected_s8 esp_nn_fully_connected_s8_opt
+#define esp_nn_fully_connected_per_ch_s8 esp_nn_fully_connected_per_ch_s8_opt
+#define esp_nn_fully_connected_batch_s8 esp_nn_fully_connected_batch_s8_opt
 
 #define esp_nn_get_softmax_scratch_size esp_nn_get_softmax_scratch_size_opt
 #define esp_nn_set_softmax_scratch_buf esp_nn_set_softmax_scratch_buf_opt
+#define esp_nn_prepare_softmax_s8 esp_nn_prepare_softmax_s8_opt
 #define esp_nn_softmax_s8 esp_nn_softmax_s8_opt
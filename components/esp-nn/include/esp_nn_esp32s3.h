@@ -221,6 +221,27 @@ void esp_nn_fully_connected_per_ch_s8_esp32s3(const int8_t *input_data,
                                        const int32_t activation_min,
                                        const int32_t activation_max);
 
+/**
+ * @brief       fully connected over a batch of input rows
+ *
+ * @note        runs esp_nn_fully_connected_s8_esp32s3 on each row, so the
+ *              same alignment constraints apply.
+ */
+void esp_nn_fully_connected_batch_s8_esp32s3(const int8_t *input_data,
+                                             const int32_t input_offset,
+                                             const uint16_t row_len,
+                                             const uint16_t batches,
+                                             const int8_t *filter_data,
+                                             const int32_t filter_offset,
+                                             const int32_t *bias,
+                                             int8_t *out_data,
+                                             const uint16_t out_channels,
+                                             const int32_t out_offset,
+                                             const int32_t out_shift,
+                                             const int32_t out_mult,
+                                             const int32_t activation_min,
+                                             const int32_t activation_max);
+
 /**
  * @brief       relu6
  *
@@ -250,7 +271,9 @@ void esp_nn_relu6_s8_esp32s3(int8_t *data, uint16_t size);
 
 #define esp_nn_fully_connected_s8 esp_nn_fully_connected_s8_esp32s3
 #define esp_nn_fully_connected_per_ch_s8 esp_nn_fully_connected_per_ch_s8_esp32s3
+#define esp_nn_fully_connected_batch_s8 esp_nn_fully_connected_batch_s8_esp32s3
 
 #define esp_nn_get_softmax_scratch_size esp_nn_get_softmax_scratch_size_opt
 #define esp_nn_set_softmax_scratch_buf esp_nn_set_softmax_scratch_buf_opt
+#define esp_nn_prepare_softmax_s8 esp_nn_prepare_softmax_s8_opt
 #define esp_nn_softmax_s8 esp_nn_softmax_s8_opt
@@ -22,8 +22,8 @@
 #include "esp_nn_defs.h"
 #include "esp_nn_ansi_headers.h"
 
-#define esp_nn_add_elementwise_s8 esp_nn_add_elementwise_s8_ansi
-#define esp_nn_mul_elementwise_s8 esp_nn_mul_elementwise_s8_ansi
+#define esp_nn_add_elementwise_s8 esp_nn_add_elementwise_s8_opt
+#define esp_nn_mul_elementwise_s8 esp_nn_mul_elementwise_s8_opt
 
 #define esp_nn_depthwise_conv_s8 esp_nn_depthwise_conv_s8_opt
 
@@ -37,12 +37,14 @@
 
 #define esp_nn_relu6_s8 esp_nn_relu6_s8_ansi
 
-#define esp_nn_avg_pool_s8 esp_nn_avg_pool_s8_ansi
-#define esp_nn_max_pool_s8 esp_nn_max_pool_s8_ansi
+#define esp_nn_avg_pool_s8 esp_nn_avg_pool_s8_opt
+#define esp_nn_max_pool_s8 esp_nn_max_pool_s8_opt
 
-#define esp_nn_fully_connected_s8 esp_nn_fully_connected_s8_ansi
-#define esp_nn_fully_connected_per_ch_s8 esp_nn_fully_connected_per_ch_s8_ansi
+#define esp_nn_fully_connected_s8 esp_nn_fully_connected_s8_opt
+#define esp_nn_fully_connected_per_ch_s8 esp_nn_fully_connected_per_ch_s8_opt
+#define esp_nn_fully_connected_batch_s8 esp_nn_fully_connected_batch_s8_opt
 
 #define esp_nn_get_softmax_scratch_size esp_nn_get_softmax_scratch_size_opt
 #define esp_nn_set_softmax_scratch_buf esp_nn_set_softmax_scratch_buf_opt
+#define esp_nn_prepare_softmax_s8 esp_nn_prepare_softmax_s8_opt
 #define esp_nn_softmax_s8 esp_nn_softmax_s8_opt
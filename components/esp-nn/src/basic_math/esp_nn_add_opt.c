@@ -0,0 +1,185 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <stdint.h>
+
+#include <esp_nn_ansi_headers.h>
+#include <common_functions.h>
+
+/* below this many elements, building a lookup table costs more than it saves */
+#define ADD_LUT_MIN_SIZE    512
+
+typedef struct {
+    int32_t offset;
+    int32_t left_shift;
+    int32_t mult;
+    esp_nn_rounding_shift_t shift;
+} add_input_params_t;
+
+typedef struct {
+    add_input_params_t in1;
+    add_input_params_t in2;
+    int32_t out_mult;
+    esp_nn_rounding_shift_t out_shift;
+    int32_t out_offset;
+    int32_t activation_min;
+    int32_t activation_max;
+} add_params_t;
+
+/**
+ * @brief   largest |x + offset| << left_shift over int8 x
+ */
+__NN_FORCE_INLINE__ int64_t esp_nn_add_input_bound(const int32_t offset, const int32_t left_shift)
+{
+    const int64_t lo = (int64_t) INT8_MIN + offset;
+    const int64_t hi = (int64_t) INT8_MAX + offset;
+    return max(lo < 0 ? -lo : lo, hi < 0 ? -hi : hi) << left_shift;
+}
+
+/**
+ * @brief   Whether the reduced requantization matches the reference for every
+ *          input: no value reaches INT32_MIN before a doubling high mul, and no
+ *          rounding shift overflows.
+ *
+ * @note    Neither the doubling high mul nor the rounding shift increase the
+ *          magnitude, so each input term stays within its bound.
+ */
+static bool esp_nn_add_fast_ok(const add_params_t *p)
+{
+    if (p->in1.left_shift < 0 || p->in1.left_shift > 31 ||
+            p->in1.shift.exponent < 0 || p->in1.shift.exponent > 31 ||
+            p->in2.shift.exponent < 0 || p->in2.shift.exponent > 31 ||
+            p->out_shift.exponent < 0 || p->out_shift.exponent > 31) {
+        return false;
+    }
+    const int64_t bound1 = esp_nn_add_input_bound(p->in1.offset, p->in1.left_shift);
+    const int64_t bound2 = esp_nn_add_input_bound(p->in2.offset, p->in2.left_shift);
+    const int64_t sum_bound = bound1 + bound2;
+    return bound1 + p->in1.shift.nudge_pos < INT32_MAX &&
+           bound2 + p->in2.shift.nudge_pos < INT32_MAX &&
+           sum_bound + p->out_shift.nudge_pos < INT32_MAX;
+}
+
+__NN_FORCE_INLINE__ int32_t esp_nn_add_input_term(const int32_t val, const add_input_params_t *in)
+{
+    const int32_t tmp = (val + in->offset) << in->left_shift;
+    return esp_nn_rounding_shift(esp_nn_doubling_high_mul_fast(tmp, in->mult), &in->shift);
+}
+
+__NN_FORCE_INLINE__ int8_t esp_nn_add_one(const int32_t val1, const int32_t val2,
+                                          const add_params_t *p)
+{
+    int32_t out = esp_nn_add_input_term(val1, &p->in1) + esp_nn_add_input_term(val2, &p->in2);
+    out = esp_nn_rounding_shift(esp_nn_doubling_high_mul_fast(out, p->out_mult), &p->out_shift);
+    out += p->out_offset;
+    out = max(p->activation_min, min(out, p->activation_max));
+    return (int8_t) out;
+}
+
+/**
+ * Returns true, with `value` set, if all `size` elements of `data` are equal.
+ */
+static bool esp_nn_add_is_constant(const int8_t *data, const int32_t size, int8_t *value)
+{
+    const int8_t first = data[0];
+    for (int32_t i = 1; i < size; i++) {
+        if (data[i] != first) {
+            return false;
+        }
+    }
+    *value = first;
+    return true;
+}
+
+void esp_nn_add_elementwise_s8_opt(const int8_t *input1_data,
+                                   const int8_t *input2_data,
+                                   const int32_t input1_offset,
+                                   const int32_t input2_offset,
+                                   const int32_t input1_mult,
+                                   const int32_t input2_mult,
+                                   const int32_t input1_shift,
+                                   const int32_t input2_shift,
+                                   const int32_t left_shift,
+                                   int8_t *output,
+                                   const int32_t out_offset,
+                                   const int32_t out_mult,
+                                   const int32_t out_shift,
+                                   const int32_t activation_min,
+                                   const int32_t activation_max,
+                                   const int32_t size)
+{
+    add_params_t p = {
+        .in1 = { .offset = input1_offset, .left_shift = left_shift, .mult = input1_mult },
+        .in2 = { .offset = input2_offset, .left_shift = left_shift, .mult = input2_mult },
+        .out_mult = out_mult,
+        .out_offset = out_offset,
+        .activation_min = activation_min,
+        .activation_max = activation_max,
+    };
+    esp_nn_rounding_shift_init(&p.in1.shift, -input1_shift);
+    esp_nn_rounding_shift_init(&p.in2.shift, -input2_shift);
+    esp_nn_rounding_shift_init(&p.out_shift, -out_shift);
+
+    if (!esp_nn_add_fast_ok(&p)) {
+        esp_nn_add_elementwise_s8_ansi(input1_data, input2_data, input1_offset, input2_offset,
+                                       input1_mult, input2_mult, input1_shift, input2_shift,
+                                       left_shift, output, out_offset, out_mult, out_shift,
+                                       activation_min, activation_max, size);
+        return;
+    }
+
+    int32_t i = 0;
+    if (size >= ADD_LUT_MIN_SIZE) {
+        /**
+         * With one operand the same everywhere, the output is a function of
+         * the other one alone: tabulate it for all 256 values.
+         */
+        int8_t lut[256];
+        int8_t value;
+        const int8_t *input = NULL;
+        if (esp_nn_add_is_constant(input2_data, size, &value)) {
+            input = input1_data;
+            for (int32_t idx = 0; idx < 256; idx++) {
+                lut[idx] = esp_nn_add_one(idx + INT8_MIN, value, &p);
+            }
+        } else if (esp_nn_add_is_constant(input1_data, size, &value)) {
+            input = input2_data;
+            for (int32_t idx = 0; idx < 256; idx++) {
+                lut[idx] = esp_nn_add_one(value, idx + INT8_MIN, &p);
+            }
+        }
+        if (input != NULL) {
+            for (; i < size - 3; i += 4) {
+                output[i + 0] = lut[input[i + 0] - INT8_MIN];
+                output[i + 1] = lut[input[i + 1] - INT8_MIN];
+                output[i + 2] = lut[input[i + 2] - INT8_MIN];
+                output[i + 3] = lut[input[i + 3] - INT8_MIN];
+            }
+            for (; i < size; i++) {
+                output[i] = lut[input[i] - INT8_MIN];
+            }
+            return;
+        }
+    }
+
+    for (; i < size - 3; i += 4) {
+        output[i + 0] = esp_nn_add_one(input1_data[i + 0], input2_data[i + 0], &p);
+        output[i + 1] = esp_nn_add_one(input1_data[i + 1], input2_data[i + 1], &p);
+        output[i + 2] = esp_nn_add_one(input1_data[i + 2], input2_data[i + 2], &p);
+        output[i + 3] = esp_nn_add_one(input1_data[i + 3], input2_data[i + 3], &p);
+    }
+    for (; i < size; i++) {
+        output[i] = esp_nn_add_one(input1_data[i], input2_data[i], &p);
+    }
+}
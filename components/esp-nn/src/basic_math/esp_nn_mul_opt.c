@@ -0,0 +1,158 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <stdint.h>
+
+#include <esp_nn_ansi_headers.h>
+#include <common_functions.h>
+
+/* below this many elements, building a lookup table costs more than it saves */
+#define MUL_LUT_MIN_SIZE    512
+
+typedef struct {
+    int32_t in1_offset;
+    int32_t in2_offset;
+    int32_t left_shift;
+    int32_t out_mult;
+    esp_nn_rounding_shift_t right_shift;
+    int32_t out_offset;
+    int32_t activation_min;
+    int32_t activation_max;
+} mul_params_t;
+
+/**
+ * @brief   largest |x + offset| over int8 x
+ */
+__NN_FORCE_INLINE__ int64_t esp_nn_mul_input_bound(const int32_t offset)
+{
+    const int64_t lo = (int64_t) INT8_MIN + offset;
+    const int64_t hi = (int64_t) INT8_MAX + offset;
+    return max(lo < 0 ? -lo : lo, hi < 0 ? -hi : hi);
+}
+
+/**
+ * @brief   Whether the reduced requantization matches
+ *          `esp_nn_multiply_by_quantized_mult` for every input: the shifted
+ *          product never reaches INT32_MIN and the rounding shift never
+ *          overflows.
+ */
+static bool esp_nn_mul_fast_ok(const mul_params_t *p)
+{
+    if (p->left_shift > 31 || p->right_shift.exponent > 31) {
+        return false;
+    }
+    const int64_t bound = (esp_nn_mul_input_bound(p->in1_offset) *
+                           esp_nn_mul_input_bound(p->in2_offset)) << p->left_shift;
+    return bound + p->right_shift.nudge_pos < INT32_MAX;
+}
+
+__NN_FORCE_INLINE__ int8_t esp_nn_mul_one(const int32_t val1, const int32_t val2,
+                                          const mul_params_t *p)
+{
+    int32_t out = ((val1 + p->in1_offset) * (val2 + p->in2_offset)) << p->left_shift;
+    out = esp_nn_rounding_shift(esp_nn_doubling_high_mul_fast(out, p->out_mult), &p->right_shift);
+    out += p->out_offset;
+    out = max(p->activation_min, min(out, p->activation_max));
+    return (int8_t) out;
+}
+
+/**
+ * Returns true, with `value` set, if all `size` elements of `data` are equal.
+ */
+static bool esp_nn_mul_is_constant(const int8_t *data, const int32_t size, int8_t *value)
+{
+    const int8_t first = data[0];
+    for (int32_t i = 1; i < size; i++) {
+        if (data[i] != first) {
+            return false;
+        }
+    }
+    *value = first;
+    return true;
+}
+
+void esp_nn_mul_elementwise_s8_opt(const int8_t *input1_data,
+                                   const int8_t *input2_data,
+                                   const int32_t input1_offset,
+                                   const int32_t input2_offset,
+                                   int8_t *output,
+                                   const int32_t out_offset,
+                                   const int32_t out_mult,
+                                   const int32_t out_shift,
+                                   const int32_t activation_min,
+                                   const int32_t activation_max,
+                                   const int32_t size)
+{
+    mul_params_t p = {
+        .in1_offset = input1_offset,
+        .in2_offset = input2_offset,
+        .left_shift = max(out_shift, 0),
+        .out_mult = out_mult,
+        .out_offset = out_offset,
+        .activation_min = activation_min,
+        .activation_max = activation_max,
+    };
+    esp_nn_rounding_shift_init(&p.right_shift, max(-out_shift, 0));
+
+    if (!esp_nn_mul_fast_ok(&p)) {
+        esp_nn_mul_elementwise_s8_ansi(input1_data, input2_data, input1_offset, input2_offset,
+                                       output, out_offset, out_mult, out_shift,
+                                       activation_min, activation_max, size);
+        return;
+    }
+
+    int32_t i = 0;
+    if (size >= MUL_LUT_MIN_SIZE) {
+        /**
+         * With one operand the same everywhere, the output is a function of
+         * the other one alone: tabulate it for all 256 values.
+         */
+        int8_t lut[256];
+        int8_t value;
+        const int8_t *input = NULL;
+        if (esp_nn_mul_is_constant(input2_data, size, &value)) {
+            input = input1_data;
+            for (int32_t idx = 0; idx < 256; idx++) {
+                lut[idx] = esp_nn_mul_one(idx + INT8_MIN, value, &p);
+            }
+        } else if (esp_nn_mul_is_constant(input1_data, size, &value)) {
+            input = input2_data;
+            for (int32_t idx = 0; idx < 256; idx++) {
+                lut[idx] = esp_nn_mul_one(value, idx + INT8_MIN, &p);
+            }
+        }
+        if (input != NULL) {
+            for (; i < size - 3; i += 4) {
+                output[i + 0] = lut[input[i + 0] - INT8_MIN];
+                output[i + 1] = lut[input[i + 1] - INT8_MIN];
+                output[i + 2] = lut[input[i + 2] - INT8_MIN];
+                output[i + 3] = lut[input[i + 3] - INT8_MIN];
+            }
+            for (; i < size; i++) {
+                output[i] = lut[input[i] - INT8_MIN];
+            }
+            return;
+        }
+    }
+
+    for (; i < size - 3; i += 4) {
+        output[i + 0] = esp_nn_mul_one(input1_data[i + 0], input2_data[i + 0], &p);
+        output[i + 1] = esp_nn_mul_one(input1_data[i + 1], input2_data[i + 1], &p);
+        output[i + 2] = esp_nn_mul_one(input1_data[i + 2], input2_data[i + 2], &p);
+        output[i + 3] = esp_nn_mul_one(input1_data[i + 3], input2_data[i + 3], &p);
+    }
+    for (; i < size; i++) {
+        output[i] = esp_nn_mul_one(input1_data[i], input2_data[i], &p);
+    }
+}
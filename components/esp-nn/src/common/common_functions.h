@@ -170,6 +170,83 @@ __NN_FORCE_INLINE__ int32_t esp_nn_multiply_by_quantized_mult_fast(int32_t x, in
     return result;
 }
 
+/**
+ * Dilation factor along one axis. 0, as passed by older callers, means 1.
+ */
+__NN_FORCE_INLINE__ int32_t esp_nn_dilation(int32_t dilation)
+{
+    return dilation > 1 ? dilation : 1;
+}
+
+/**
+ * Whether a filter actually samples a dilated window. 1x1 filters never do.
+ */
+__NN_FORCE_INLINE__ int32_t esp_nn_is_dilated(int32_t filter_wd, int32_t filter_ht,
+                                              int32_t dilation_wd, int32_t dilation_ht)
+{
+    return (filter_wd > 1 && dilation_wd > 1) || (filter_ht > 1 && dilation_ht > 1);
+}
+
+/**
+ * First filter tap along one axis whose input position
+ * `base + tap * dilation` is not before the start of the input.
+ */
+__NN_FORCE_INLINE__ int32_t esp_nn_filter_tap_start(int32_t base, int32_t dilation)
+{
+    if (base >= 0) {
+        return 0;
+    }
+    return dilation == 1 ? -base : (dilation - 1 - base) / dilation;
+}
+
+/**
+ * One past the last filter tap along one axis whose input position
+ * `base + tap * dilation` is before `input_size`.
+ */
+__NN_FORCE_INLINE__ int32_t esp_nn_filter_tap_end(int32_t base, int32_t input_size,
+                                                  int32_t filter_size, int32_t dilation)
+{
+    if (base >= input_size) {
+        return 0;
+    }
+    if (dilation == 1) {
+        return min(filter_size, input_size - base);
+    }
+    return min(filter_size, (input_size - base + dilation - 1) / dilation);
+}
+
+/**
+ * `esp_nn_sat_round_doubling_high_mul` for callers that guarantee `x` is
+ * never INT32_MIN, the only case where the two differ.
+ */
+__NN_FORCE_INLINE__ int32_t esp_nn_doubling_high_mul_fast(int32_t x, int32_t mult)
+{
+    return (int32_t) (((int64_t) x * mult + (1 << 30)) >> 31);
+}
+
+/**
+ * Rounding right shift with its nudges worked out once, outside the loop.
+ * Same result as `esp_nn_div_by_power_of_two` for exponents in [0, 31], as
+ * long as |val| + 2^(exponent - 1) does not overflow.
+ */
+typedef struct {
+    int32_t exponent;
+    int32_t nudge_pos;
+    int32_t nudge_neg;
+} esp_nn_rounding_shift_t;
+
+__NN_FORCE_INLINE__ void esp_nn_rounding_shift_init(esp_nn_rounding_shift_t *rs, int32_t exponent)
+{
+    rs->exponent = exponent;
+    rs->nudge_pos = exponent ? (int32_t) (1u << (exponent - 1)) : 0;
+    rs->nudge_neg = exponent ? rs->nudge_pos - 1 : 0;
+}
+
+__NN_FORCE_INLINE__ int32_t esp_nn_rounding_shift(int32_t val, const esp_nn_rounding_shift_t *rs)
+{
+    return (val + (val < 0 ? rs->nudge_neg : rs->nudge_pos)) >> rs->exponent;
+}
+
 static void esp_nn_aligned_s8_pad_with_value(const int8_t *src, int8_t *dst,
                                              const uint16_t input_wd,
                                              const uint16_t input_ht,
@@ -253,3 +330,26 @@ __NN_FORCE_INLINE__ void esp_nn_s8_to_s16(const int8_t *src, int16_t *dst, const
         dst[i] = src[i];
     }
 }
+
+/**
+ * @brief       load four int8 values as one 32 bit word
+ *
+ * @param       ptr 4 byte aligned source
+ */
+__NN_FORCE_INLINE__ uint32_t esp_nn_load_s8x4(const int8_t *ptr)
+{
+    uint32_t val;
+    memcpy(&val, __builtin_assume_aligned(ptr, 4), sizeof(val));
+    return val;
+}
+
+/**
+ * @brief       store one 32 bit word as four int8 values
+ *
+ * @param       ptr 4 byte aligned destination
+ * @param       val packed values
+ */
+__NN_FORCE_INLINE__ void esp_nn_store_s8x4(int8_t *ptr, const uint32_t val)
+{
+    memcpy(__builtin_assume_aligned(ptr, 4), &val, sizeof(val));
+}
@@ -104,7 +104,7 @@ void esp_nn_conv_u8_ansi(const uint8_t *input_data,
 /**
  * Assumption 1: i/p channels == o/p channels
  * Assumption 2: Pointers are valid
- * Assumption 3: dialation width = 1
+ * Dilation 0 is treated as 1.
  */
 void esp_nn_conv_s8_ansi(const data_dims_t *input_dims,
                          const int8_t *input_data,
@@ -125,6 +125,8 @@ void esp_nn_conv_s8_ansi(const data_dims_t *input_dims,
     const uint16_t pad_ht = conv_params->padding.height;
     const uint16_t stride_wd = conv_params->stride.width;
     const uint16_t stride_ht = conv_params->stride.height;
+    const int32_t dilation_wd = esp_nn_dilation(conv_params->dilation.width);
+    const int32_t dilation_ht = esp_nn_dilation(conv_params->dilation.height);
     const uint16_t filter_wd = filter_dims->width;
     const uint16_t filter_ht = filter_dims->height;
     const uint16_t out_wd = output_dims->width;
@@ -145,16 +147,16 @@ void esp_nn_conv_s8_ansi(const data_dims_t *input_dims,
                 const int32_t base_y = stride_ht * out_y - pad_ht;
                 const int32_t base_x = stride_wd * out_x - pad_wd;
 
-                const int32_t filter_y_start = max(0, -base_y);
-                const int32_t filter_x_start = max(0, -base_x);
+                const int32_t filter_y_start = esp_nn_filter_tap_start(base_y, dilation_ht);
+                const int32_t filter_x_start = esp_nn_filter_tap_start(base_x, dilation_wd);
 
-                const int32_t filter_y_end = min(filter_ht, input_ht - base_y);
-                const int32_t filter_x_end = min(filter_wd, input_wd - base_x);
+                const int32_t filter_y_end = esp_nn_filter_tap_end(base_y, input_ht, filter_ht, dilation_ht);
+                const int32_t filter_x_end = esp_nn_filter_tap_end(base_x, input_wd, filter_wd, dilation_wd);
 
                 for (filter_y_idx = filter_y_start; filter_y_idx < filter_y_end; filter_y_idx++) {
                     for (filter_x_idx = filter_x_start; filter_x_idx < filter_x_end; filter_x_idx++) {
-                        const int32_t in_row = base_y + filter_y_idx;
-                        const int32_t in_col = base_x + filter_x_idx;
+                        const int32_t in_row = base_y + filter_y_idx * dilation_ht;
+                        const int32_t in_col = base_x + filter_x_idx * dilation_wd;
                         int32_t input_base_offset = (in_row * input_wd + in_col) * in_channels;
                         int32_t filter_base_offset = out_ch_idx * in_channels * filter_ht * filter_wd +
                                                        (filter_y_idx * filter_wd + filter_x_idx) * in_channels;
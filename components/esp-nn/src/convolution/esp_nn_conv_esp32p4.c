@@ -369,6 +369,10 @@ int esp_nn_get_conv_scratch_size_esp32p4(const data_dims_t *input_dims,
                                          const data_dims_t *output_dims,
                                          const conv_params_t *conv_params)
 {
+    if (esp_nn_is_dilated(filter_dims->width, filter_dims->height,
+                          conv_params->dilation.width, conv_params->dilation.height)) {
+        return esp_nn_get_conv_scratch_size_opt(input_dims, filter_dims, output_dims, conv_params);
+    }
     const uint16_t input_wd = input_dims->width;
     const uint16_t input_ht = input_dims->height;
     const uint16_t in_ch = input_dims->channels;
@@ -442,6 +446,15 @@ void esp_nn_conv_s8_esp32p4(const data_dims_t *input_dims,
         printf("esp_nn_conv error! scratch_buffer not set!\n");
         return;
     }
+    if (esp_nn_is_dilated(filter_dims->width, filter_dims->height,
+                          conv_params->dilation.width, conv_params->dilation.height)) {
+        /* generic kernel, on the scratch sized for it by get_scratch_size */
+        esp_nn_set_conv_scratch_buf_opt(scratch_buffer);
+        esp_nn_conv_s8_opt(input_dims, input, filter_dims, filter_data, bias,
+                           output_dims, out_data, conv_params, quant_data);
+        esp_nn_set_conv_scratch_buf_opt(NULL);
+        return;
+    }
 
     const uint16_t filter_wd = filter_dims->width;
     const uint16_t filter_ht = filter_dims->height;
@@ -0,0 +1,476 @@
+// Copyright 2020-2021 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <esp_nn_defs.h>
+
+#include <common_functions.h>
+#include <string.h>
+
+/* Output pixels unrolled into the scratch buffer per GEMM tile */
+#define CONV_IM2COL_PIXELS 4
+
+/* Output pixels and output channels per 1x1 register tile (4x4 unrolled) */
+#define CONV_1X1_TILE 4
+
+/**
+ * Scratch layout (non-1x1 filters): one int32 per output channel holding
+ * `input_offset * sum(filter) + bias`, followed by CONV_IM2COL_PIXELS raw
+ * int8 im2col patches. 1x1 filters keep their folded terms in registers.
+ */
+static int32_t *scratch_buffer = NULL;
+
+int esp_nn_get_conv_scratch_size_opt(const data_dims_t *input_dims,
+                                     const data_dims_t *filter_dims,
+                                     const data_dims_t *output_dims,
+                                     const conv_params_t *conv_params)
+{
+    const uint16_t filter_wd = filter_dims->width;
+    const uint16_t filter_ht = filter_dims->height;
+    if (filter_wd == 1 && filter_ht == 1) {
+        return 0;
+    }
+    return output_dims->channels * sizeof(int32_t) + CONV_IM2COL_PIXELS * filter_wd * filter_ht * input_dims->channels;
+}
+
+void esp_nn_set_conv_scratch_buf_opt(const void *buf)
+{
+    scratch_buffer = (int32_t *) buf;
+}
+
+/**
+ * fold[ch] = input_offset * sum(filter[ch]) + bias[ch]
+ *
+ * With this added once per output, (input + input_offset) * filter reduces to
+ * a plain int8 dot product of input and filter.
+ */
+__NN_FORCE_INLINE__ void esp_nn_conv_fold_offset_bias(const int8_t *filter_data,
+                                                      const int32_t *bias,
+                                                      const int32_t filter_len,
+                                                      const uint16_t out_channels,
+                                                      const int32_t input_offset,
+                                                      int32_t *fold)
+{
+    for (int32_t out_ch_idx = 0; out_ch_idx < out_channels; out_ch_idx++) {
+        int32_t filter_sum = 0;
+        for (int32_t k = 0; k < filter_len; k++) {
+            filter_sum += *filter_data++;
+        }
+        fold[out_ch_idx] = filter_sum * input_offset + (bias ? bias[out_ch_idx] : 0);
+    }
+}
+
+__NN_FORCE_INLINE__ int8_t esp_nn_conv_requant(int32_t conv_out,
+                                               const int32_t out_ch_idx,
+                                               const quant_data_t *quant_data,
+                                               const int32_t out_offset,
+                                               const int32_t activation_min,
+                                               const int32_t activation_max)
+{
+    conv_out = esp_nn_multiply_by_quantized_mult_fast(conv_out, quant_data->mult[out_ch_idx],
+                                                      quant_data->shift[out_ch_idx]);
+    conv_out += out_offset;
+    conv_out = max(conv_out, activation_min);
+    conv_out = min(conv_out, activation_max);
+    return (int8_t) conv_out;
+}
+
+/**
+ * 4 output pixels x 4 output channels of a 1x1 conv. The pixels are
+ * `pix_step` bytes apart in the input and the filter rows `in_channels`
+ * apart, so each input and filter byte is loaded once per tile and the 16
+ * accumulators stay in registers.
+ */
+__NN_FORCE_INLINE__ void esp_nn_conv_1x1_tile_4x4(const int8_t *input,
+                                                  const int32_t pix_step,
+                                                  const int8_t *filter_data,
+                                                  const uint16_t in_channels,
+                                                  int32_t *acc)
+{
+    const int8_t *in_0 = input;
+    const int8_t *in_1 = in_0 + pix_step;
+    const int8_t *in_2 = in_1 + pix_step;
+    const int8_t *in_3 = in_2 + pix_step;
+    const int8_t *filter_0 = filter_data;
+    const int8_t *filter_1 = filter_0 + in_channels;
+    const int8_t *filter_2 = filter_1 + in_channels;
+    const int8_t *filter_3 = filter_2 + in_channels;
+    int32_t acc_00 = 0, acc_01 = 0, acc_02 = 0, acc_03 = 0;
+    int32_t acc_10 = 0, acc_11 = 0, acc_12 = 0, acc_13 = 0;
+    int32_t acc_20 = 0, acc_21 = 0, acc_22 = 0, acc_23 = 0;
+    int32_t acc_30 = 0, acc_31 = 0, acc_32 = 0, acc_33 = 0;
+
+    for (int32_t k = 0; k < in_channels; k++) {
+        const int32_t x_0 = in_0[k], x_1 = in_1[k], x_2 = in_2[k], x_3 = in_3[k];
+        const int32_t f_0 = filter_0[k], f_1 = filter_1[k], f_2 = filter_2[k], f_3 = filter_3[k];
+        acc_00 += x_0 * f_0; acc_01 += x_0 * f_1; acc_02 += x_0 * f_2; acc_03 += x_0 * f_3;
+        acc_10 += x_1 * f_0; acc_11 += x_1 * f_1; acc_12 += x_1 * f_2; acc_13 += x_1 * f_3;
+        acc_20 += x_2 * f_0; acc_21 += x_2 * f_1; acc_22 += x_2 * f_2; acc_23 += x_2 * f_3;
+        acc_30 += x_3 * f_0; acc_31 += x_3 * f_1; acc_32 += x_3 * f_2; acc_33 += x_3 * f_3;
+    }
+    acc[0] = acc_00; acc[1] = acc_01; acc[2] = acc_02; acc[3] = acc_03;
+    acc[4] = acc_10; acc[5] = acc_11; acc[6] = acc_12; acc[7] = acc_13;
+    acc[8] = acc_20; acc[9] = acc_21; acc[10] = acc_22; acc[11] = acc_23;
+    acc[12] = acc_30; acc[13] = acc_31; acc[14] = acc_32; acc[15] = acc_33;
+}
+
+/* remainder path: a single output pixel x channel */
+__NN_FORCE_INLINE__ int32_t esp_nn_conv_1x1_dot(const int8_t *input,
+                                                const int8_t *filter_data,
+                                                const uint16_t in_channels)
+{
+    int32_t acc = 0;
+    int32_t k = 0;
+    for (; k < in_channels - 3; k += 4) {
+        acc += input[k + 0] * filter_data[k + 0];
+        acc += input[k + 1] * filter_data[k + 1];
+        acc += input[k + 2] * filter_data[k + 2];
+        acc += input[k + 3] * filter_data[k + 3];
+    }
+    for (; k < in_channels; k++) {
+        acc += input[k] * filter_data[k];
+    }
+    return acc;
+}
+
+/**
+ * 1x1 conv as a GEMM over CONV_1X1_TILE channels x CONV_1X1_TILE pixels of
+ * one output row. Channel groups are the outer loop so their folded
+ * offset/bias terms are computed once and stay in registers. Leftover
+ * channels and the pixels at the end of each row take the remainder path.
+ */
+__attribute__ ((noinline))
+static void esp_nn_conv_s8_1x1(const data_dims_t *input_dims,
+                               const int8_t *input_data,
+                               const int8_t *filter_data,
+                               const int32_t *bias,
+                               const data_dims_t *output_dims,
+                               int8_t *out_data,
+                               const conv_params_t *conv_params,
+                               const quant_data_t *quant_data)
+{
+    const uint16_t input_wd = input_dims->width;
+    const uint16_t in_channels = input_dims->channels;
+    const int32_t out_offset = conv_params->out_offset;
+    const uint16_t stride_wd = conv_params->stride.width;
+    const uint16_t stride_ht = conv_params->stride.height;
+    const uint16_t out_wd = output_dims->width;
+    const uint16_t out_ht = output_dims->height;
+    const uint16_t out_channels = output_dims->channels;
+    const int32_t activation_min = conv_params->activation.min;
+    const int32_t activation_max = conv_params->activation.max;
+    const int32_t pix_step = stride_wd * in_channels;
+
+    int32_t out_ch_idx = 0;
+    for (; out_ch_idx < out_channels - (CONV_1X1_TILE - 1); out_ch_idx += CONV_1X1_TILE) {
+        const int8_t *filter_ptr = filter_data + out_ch_idx * in_channels;
+        int32_t fold[CONV_1X1_TILE];
+        esp_nn_conv_fold_offset_bias(filter_ptr, bias ? bias + out_ch_idx : NULL, in_channels,
+                                     CONV_1X1_TILE, conv_params->in_offset, fold);
+
+        for (int32_t out_y = 0; out_y < out_ht; out_y++) {
+            const int8_t *input_row = input_data + out_y * stride_ht * input_wd * in_channels;
+            int8_t *out_ptr = out_data + out_y * out_wd * out_channels + out_ch_idx;
+            int32_t out_x = 0;
+            for (; out_x < out_wd - (CONV_1X1_TILE - 1); out_x += CONV_1X1_TILE) {
+                int32_t acc[CONV_1X1_TILE * CONV_1X1_TILE];
+                esp_nn_conv_1x1_tile_4x4(input_row + out_x * pix_step, pix_step,
+                                         filter_ptr, in_channels, acc);
+                for (int32_t p = 0; p < CONV_1X1_TILE; p++) {
+                    for (int32_t c = 0; c < CONV_1X1_TILE; c++) {
+                        out_ptr[c] = esp_nn_conv_requant(acc[p * CONV_1X1_TILE + c] + fold[c],
+                                                         out_ch_idx + c, quant_data, out_offset,
+                                                         activation_min, activation_max);
+                    }
+                    out_ptr += out_channels;
+                }
+            }
+            for (; out_x < out_wd; out_x++) {
+                const int8_t *input_ptr = input_row + out_x * pix_step;
+                for (int32_t c = 0; c < CONV_1X1_TILE; c++) {
+                    const int32_t conv_out = esp_nn_conv_1x1_dot(input_ptr, filter_ptr + c * in_channels,
+                                                                 in_channels);
+                    out_ptr[c] = esp_nn_conv_requant(conv_out + fold[c], out_ch_idx + c, quant_data,
+                                                     out_offset, activation_min, activation_max);
+                }
+                out_ptr += out_channels;
+            }
+        }
+    }
+
+    for (; out_ch_idx < out_channels; out_ch_idx++) {
+        const int8_t *filter_ptr = filter_data + out_ch_idx * in_channels;
+        int32_t fold;
+        esp_nn_conv_fold_offset_bias(filter_ptr, bias ? bias + out_ch_idx : NULL, in_channels,
+                                     1, conv_params->in_offset, &fold);
+
+        for (int32_t out_y = 0; out_y < out_ht; out_y++) {
+            const int8_t *input_row = input_data + out_y * stride_ht * input_wd * in_channels;
+            int8_t *out_ptr = out_data + out_y * out_wd * out_channels + out_ch_idx;
+            for (int32_t out_x = 0; out_x < out_wd; out_x++) {
+                const int32_t conv_out = esp_nn_conv_1x1_dot(input_row + out_x * pix_step,
+                                                             filter_ptr, in_channels);
+                *out_ptr = esp_nn_conv_requant(conv_out + fold, out_ch_idx, quant_data,
+                                               out_offset, activation_min, activation_max);
+                out_ptr += out_channels;
+            }
+        }
+    }
+}
+
+/**
+ * Unroll the (dilated) receptive field of one output pixel into `patch`, in
+ * filter order (y, x, channel), as raw int8. Taps in the padding are stored as
+ * -input_offset: the folded term then cancels them, as the reference skips
+ * them. Needs -input_offset to fit in int8, checked by the caller.
+ */
+__NN_FORCE_INLINE__ void esp_nn_conv_im2col_patch(const int8_t *input_data,
+                                                  const uint16_t input_wd,
+                                                  const uint16_t input_ht,
+                                                  const uint16_t in_channels,
+                                                  const int32_t input_offset,
+                                                  const uint16_t filter_wd,
+                                                  const uint16_t filter_ht,
+                                                  const int32_t dilation_wd,
+                                                  const int32_t dilation_ht,
+                                                  const int32_t base_y,
+                                                  const int32_t base_x,
+                                                  int8_t *patch)
+{
+    for (int32_t filter_y_idx = 0; filter_y_idx < filter_ht; filter_y_idx++) {
+        const int32_t in_row = base_y + filter_y_idx * dilation_ht;
+        for (int32_t filter_x_idx = 0; filter_x_idx < filter_wd; filter_x_idx++) {
+            const int32_t in_col = base_x + filter_x_idx * dilation_wd;
+            if (in_row < 0 || in_row >= input_ht || in_col < 0 || in_col >= input_wd) {
+                memset(patch, -input_offset, in_channels);
+            } else {
+                memcpy(patch, input_data + (in_row * input_wd + in_col) * in_channels, in_channels);
+            }
+            patch += in_channels;
+        }
+    }
+}
+
+/**
+ * im2col + GEMM: CONV_IM2COL_PIXELS output pixels are unrolled into the
+ * scratch buffer behind the folded offset/bias terms, then each filter row (contiguous, same (y, x, channel)
+ * order as the patches) is multiplied against all of them. A register tile
+ * of 2 output channels x 4 pixels loads each filter value once per 4
+ * pixels and each patch value once per 2 channels, and the padding and
+ * pointer arithmetic leave the inner loop.
+ */
+__attribute__ ((noinline))
+static void esp_nn_conv_s8_im2col(const data_dims_t *input_dims,
+                                  const int8_t *input_data,
+                                  const data_dims_t *filter_dims,
+                                  const int8_t *filter_data,
+                                  const int32_t *bias,
+                                  const data_dims_t *output_dims,
+                                  int8_t *out_data,
+                                  const conv_params_t *conv_params,
+                                  const quant_data_t *quant_data)
+{
+    const uint16_t input_wd = input_dims->width;
+    const uint16_t input_ht = input_dims->height;
+    const uint16_t in_channels = input_dims->channels;
+    const uint16_t filter_wd = filter_dims->width;
+    const uint16_t filter_ht = filter_dims->height;
+    const int32_t input_offset = conv_params->in_offset;
+    const int32_t out_offset = conv_params->out_offset;
+    const uint16_t pad_wd = conv_params->padding.width;
+    const uint16_t pad_ht = conv_params->padding.height;
+    const uint16_t stride_wd = conv_params->stride.width;
+    const uint16_t stride_ht = conv_params->stride.height;
+    const int32_t dilation_wd = esp_nn_dilation(conv_params->dilation.width);
+    const int32_t dilation_ht = esp_nn_dilation(conv_params->dilation.height);
+    const uint16_t out_wd = output_dims->width;
+    const uint16_t out_channels = output_dims->channels;
+    const int32_t activation_min = conv_params->activation.min;
+    const int32_t activation_max = conv_params->activation.max;
+    const int32_t patch_len = filter_wd * filter_ht * in_channels;
+    const int32_t out_pixels = out_wd * output_dims->height;
+
+    const int32_t *fold = scratch_buffer;
+    int8_t *patches = (int8_t *) (scratch_buffer + out_channels);
+    const int8_t *patch_0 = patches;
+    const int8_t *patch_1 = patch_0 + patch_len;
+    const int8_t *patch_2 = patch_1 + patch_len;
+    const int8_t *patch_3 = patch_2 + patch_len;
+
+    esp_nn_conv_fold_offset_bias(filter_data, bias, patch_len, out_channels,
+                                 input_offset, scratch_buffer);
+
+    for (int32_t pix = 0; pix < out_pixels; pix += CONV_IM2COL_PIXELS) {
+        /* a short last tile leaves stale patches, computed but not stored */
+        const int32_t n_pix = min(CONV_IM2COL_PIXELS, out_pixels - pix);
+        for (int32_t p = 0; p < n_pix; p++) {
+            const int32_t out_y = (pix + p) / out_wd;
+            const int32_t out_x = (pix + p) % out_wd;
+            esp_nn_conv_im2col_patch(input_data, input_wd, input_ht, in_channels, input_offset,
+                                     filter_wd, filter_ht, dilation_wd, dilation_ht,
+                                     stride_ht * out_y - pad_ht,
+                                     stride_wd * out_x - pad_wd, patches + p * patch_len);
+        }
+
+        int8_t *out_ptr = out_data + pix * out_channels;
+        int32_t out_ch_idx = 0;
+        for (; out_ch_idx < out_channels - 1; out_ch_idx += 2) {
+            const int8_t *filter_0 = filter_data + out_ch_idx * patch_len;
+            const int8_t *filter_1 = filter_0 + patch_len;
+            int32_t acc_0[CONV_IM2COL_PIXELS] = {0};
+            int32_t acc_1[CONV_IM2COL_PIXELS] = {0};
+
+            for (int32_t k = 0; k < patch_len; k++) {
+                const int32_t f_0 = filter_0[k];
+                const int32_t f_1 = filter_1[k];
+                const int32_t in_0 = patch_0[k], in_1 = patch_1[k];
+                const int32_t in_2 = patch_2[k], in_3 = patch_3[k];
+                acc_0[0] += f_0 * in_0;
+                acc_1[0] += f_1 * in_0;
+                acc_0[1] += f_0 * in_1;
+                acc_1[1] += f_1 * in_1;
+                acc_0[2] += f_0 * in_2;
+                acc_1[2] += f_1 * in_2;
+                acc_0[3] += f_0 * in_3;
+                acc_1[3] += f_1 * in_3;
+            }
+
+            for (int32_t p = 0; p < n_pix; p++) {
+                out_ptr[p * out_channels + out_ch_idx] =
+                    esp_nn_conv_requant(acc_0[p] + fold[out_ch_idx], out_ch_idx, quant_data,
+                                        out_offset, activation_min, activation_max);
+                out_ptr[p * out_channels + out_ch_idx + 1] =
+                    esp_nn_conv_requant(acc_1[p] + fold[out_ch_idx + 1], out_ch_idx + 1, quant_data,
+                                        out_offset, activation_min, activation_max);
+            }
+        }
+
+        for (; out_ch_idx < out_channels; out_ch_idx++) {
+            const int8_t *filter = filter_data + out_ch_idx * patch_len;
+            int32_t acc[CONV_IM2COL_PIXELS] = {0};
+            for (int32_t k = 0; k < patch_len; k++) {
+                const int32_t f = filter[k];
+                acc[0] += f * patch_0[k];
+                acc[1] += f * patch_1[k];
+                acc[2] += f * patch_2[k];
+                acc[3] += f * patch_3[k];
+            }
+            for (int32_t p = 0; p < n_pix; p++) {
+                out_ptr[p * out_channels + out_ch_idx] =
+                    esp_nn_conv_requant(acc[p] + fold[out_ch_idx], out_ch_idx, quant_data,
+                                        out_offset, activation_min, activation_max);
+            }
+        }
+    }
+}
+
+/**
+ * Assumption 1: i/p channels == o/p channels
+ * Assumption 2: Pointers are valid
+ * Dilation 0 is treated as 1; it does not affect 1x1 filters.
+ */
+void esp_nn_conv_s8_opt(const data_dims_t *input_dims,
+                        const int8_t *input_data,
+                        const data_dims_t *filter_dims,
+                        const int8_t *filter_data,
+                        const int32_t *bias,
+                        const data_dims_t *output_dims,
+                        int8_t *out_data,
+                        const conv_params_t *conv_params,
+                        const quant_data_t *quant_data)
+{
+    const uint16_t filter_wd = filter_dims->width;
+    const uint16_t filter_ht = filter_dims->height;
+
+    if (filter_wd == 1 && filter_ht == 1) {
+        esp_nn_conv_s8_1x1(input_dims, input_data, filter_data, bias,
+                           output_dims, out_data, conv_params, quant_data);
+        return;
+    }
+
+    /* padding taps are stored as -input_offset, which must fit in int8 */
+    const int32_t input_offset = conv_params->in_offset;
+    if (scratch_buffer && input_offset >= -INT8_MAX && input_offset <= -INT8_MIN) {
+        esp_nn_conv_s8_im2col(input_dims, input_data, filter_dims, filter_data, bias,
+                              output_dims, out_data, conv_params, quant_data);
+        return;
+    }
+
+    const uint16_t input_wd = input_dims->width;
+    const uint16_t input_ht = input_dims->height;
+    const uint16_t in_channels = input_dims->channels;
+    const int32_t out_offset = conv_params->out_offset;
+    const uint16_t pad_wd = conv_params->padding.width;
+    const uint16_t pad_ht = conv_params->padding.height;
+    const uint16_t stride_wd = conv_params->stride.width;
+    const uint16_t stride_ht = conv_params->stride.height;
+    const int32_t dilation_wd = esp_nn_dilation(conv_params->dilation.width);
+    const int32_t dilation_ht = esp_nn_dilation(conv_params->dilation.height);
+    const uint16_t out_wd = output_dims->width;
+    const uint16_t out_ht = output_dims->height;
+    const uint16_t out_channels = output_dims->channels;
+    const int32_t activation_min = conv_params->activation.min;
+    const int32_t activation_max = conv_params->activation.max;
+
+    int32_t out_ch_idx, out_y, out_x, filter_y_idx, filter_x_idx;
+
+    for (out_y = 0; out_y < out_ht; out_y++) {
+        for (out_x = 0; out_x < out_wd; out_x++) {
+            const int32_t *out_shift = quant_data->shift;
+            const int32_t *out_mult = quant_data->mult;
+            for (out_ch_idx = 0; out_ch_idx < out_channels; out_ch_idx++) {
+                int32_t conv_out = 0;
+
+                const int32_t base_y = stride_ht * out_y - pad_ht;
+                const int32_t base_x = stride_wd * out_x - pad_wd;
+
+                const int32_t filter_y_start = esp_nn_filter_tap_start(base_y, dilation_ht);
+                const int32_t filter_x_start = esp_nn_filter_tap_start(base_x, dilation_wd);
+
+                const int32_t filter_y_end = esp_nn_filter_tap_end(base_y, input_ht, filter_ht, dilation_ht);
+                const int32_t filter_x_end = esp_nn_filter_tap_end(base_x, input_wd, filter_wd, dilation_wd);
+
+                for (filter_y_idx = filter_y_start; filter_y_idx < filter_y_end; filter_y_idx++) {
+                    for (filter_x_idx = filter_x_start; filter_x_idx < filter_x_end; filter_x_idx++) {
+                        const int32_t in_row = base_y + filter_y_idx * dilation_ht;
+                        const int32_t in_col = base_x + filter_x_idx * dilation_wd;
+
+                        const int8_t *input_ptr = input_data +
+                                        (in_row * input_wd + in_col) * in_channels;
+                        const int8_t *filter_ptr = filter_data +
+                                        out_ch_idx * in_channels * filter_ht * filter_wd +
+                                        (filter_y_idx * filter_wd + filter_x_idx) * in_channels;
+                        int32_t in_ch_idx = 0;
+                        for (; in_ch_idx < in_channels - 3; in_ch_idx += 4) {
+                            conv_out += (*input_ptr++ + input_offset) * *filter_ptr++;
+                            conv_out += (*input_ptr++ + input_offset) * *filter_ptr++;
+                            conv_out += (*input_ptr++ + input_offset) * *filter_ptr++;
+                            conv_out += (*input_ptr++ + input_offset) * *filter_ptr++;
+                        }
+                        for (; in_ch_idx < in_channels; in_ch_idx ++) {
+                            conv_out += (*input_ptr++ + input_offset) * *filter_ptr++;
+                        }
+                    }
+                }
+                if (bias) {
+                    conv_out += bias[out_ch_idx];
+                }
+                conv_out = esp_nn_multiply_by_quantized_mult_fast(conv_out, *out_mult++, *out_shift++);
+                conv_out += out_offset;
+                conv_out = max(conv_out, activation_min);
+                conv_out = min(conv_out, activation_max);
+                *out_data++ = (int8_t) conv_out;
+            }
+        }
+    }
+}
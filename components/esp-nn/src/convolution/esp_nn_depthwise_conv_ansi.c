@@ -47,6 +47,8 @@ void esp_nn_depthwise_conv_s8_ansi(const data_dims_t *input_dims,
     const uint16_t pad_ht = conv_params->padding.height;
     const uint16_t stride_wd = conv_params->stride.width;
     const uint16_t stride_ht = conv_params->stride.height;
+    const int32_t dilation_wd = esp_nn_dilation(conv_params->dilation.width);
+    const int32_t dilation_ht = esp_nn_dilation(conv_params->dilation.height);
     const uint16_t filter_wd = filter_dims->width;
     const uint16_t filter_ht = filter_dims->height;
     const uint16_t out_wd = output_dims->width;
@@ -68,15 +70,15 @@ void esp_nn_depthwise_conv_s8_ansi(const data_dims_t *input_dims,
                     const int out_ch_idx = ch_mult_idx + ch_idx * ch_mult;
 
                     /* Select filter so as the point doesn't lie outside block */
-                    int filter_y_start = max(0, -base_y);
-                    int filter_x_start = max(0, -base_x);
-                    int filter_y_end = min(filter_ht, input_ht - base_y);
-                    int filter_x_end = min(filter_wd, input_wd - base_x);
+                    int filter_y_start = esp_nn_filter_tap_start(base_y, dilation_ht);
+                    int filter_x_start = esp_nn_filter_tap_start(base_x, dilation_wd);
+                    int filter_y_end = esp_nn_filter_tap_end(base_y, input_ht, filter_ht, dilation_ht);
+                    int filter_x_end = esp_nn_filter_tap_end(base_x, input_wd, filter_wd, dilation_wd);
 
                     for (int filter_y_idx = filter_y_start; filter_y_idx < filter_y_end; filter_y_idx++) {
-                        const int32_t idx_y = base_y + filter_y_idx;
+                        const int32_t idx_y = base_y + filter_y_idx * dilation_ht;
                         for (int filter_x_idx = filter_x_start; filter_x_idx < filter_x_end; filter_x_idx++) {
-                            const int32_t idx_x = base_x + filter_x_idx;
+                            const int32_t idx_x = base_x + filter_x_idx * dilation_wd;
                             int32_t input_index = (idx_y * input_wd + idx_x) * channels + ch_idx;
                             int32_t filter_index = (filter_y_idx * filter_wd + filter_x_idx) * (channels * ch_mult) + out_ch_idx;
                             int32_t input_val = input_data[input_index] + input_offset;
@@ -0,0 +1,699 @@
+// Copyright 2020-2021 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <esp_nn_defs.h>
+#include <common_functions.h>
+#include <string.h>
+
+/**
+ * Scratch layout: two int32 per output channel. The first holds
+ * `input_offset * sum(filter) + bias` over the whole window, the second the
+ * same sum over the in-bounds taps of the last border window used.
+ */
+static int32_t *scratch_buffer = NULL;
+
+int esp_nn_get_depthwise_conv_scratch_size_opt(const data_dims_t *input_dims,
+                                               const data_dims_t *filter_dims,
+                                               const data_dims_t *output_dims,
+                                               const dw_conv_params_t *conv_params)
+{
+    return 2 * output_dims->channels * sizeof(int32_t);
+}
+
+void esp_nn_set_depthwise_conv_scratch_buf_opt(const void *buf)
+{
+    scratch_buffer = (int32_t *) buf;
+}
+
+/**
+ * fold[ch] = input_offset * sum(filter[ch]) + bias[ch], with the filter sum
+ * taken over taps [y_start, y_end) x [x_start, x_end) only. Adding it once
+ * per output turns (input + input_offset) * filter into a plain int8 dot
+ * product, including at the borders where the reference skips padded taps.
+ */
+__NN_FORCE_INLINE__ void esp_nn_depthwise_fold_offset_bias(const int8_t *filter_data,
+                                                           const int32_t *bias,
+                                                           const uint16_t filter_wd,
+                                                           const uint16_t out_channels,
+                                                           const int32_t y_start,
+                                                           const int32_t y_end,
+                                                           const int32_t x_start,
+                                                           const int32_t x_end,
+                                                           const int32_t input_offset,
+                                                           int32_t *fold)
+{
+    memset(fold, 0, out_channels * sizeof(int32_t));
+    for (int32_t filter_y_idx = y_start; filter_y_idx < y_end; filter_y_idx++) {
+        for (int32_t filter_x_idx = x_start; filter_x_idx < x_end; filter_x_idx++) {
+            const int8_t *filter_ptr = filter_data + (filter_y_idx * filter_wd + filter_x_idx) * out_channels;
+            for (int32_t out_ch_idx = 0; out_ch_idx < out_channels; out_ch_idx++) {
+                fold[out_ch_idx] += filter_ptr[out_ch_idx];
+            }
+        }
+    }
+    for (int32_t out_ch_idx = 0; out_ch_idx < out_channels; out_ch_idx++) {
+        fold[out_ch_idx] = fold[out_ch_idx] * input_offset + (bias ? bias[out_ch_idx] : 0);
+    }
+}
+
+/* common channel multiplier == 1 case */
+__attribute__ ((noinline))
+static void esp_nn_depthwise_conv_s8_ch_mult_1(const data_dims_t *input_dims,
+                                               const int8_t *input_data,
+                                               const data_dims_t *filter_dims,
+                                               const int8_t *filter_data,
+                                               const int32_t *bias,
+                                               const data_dims_t *output_dims,
+                                               int8_t *out_data,
+                                               const dw_conv_params_t *conv_params,
+                                               const quant_data_t *quant_data)
+{
+    const uint16_t input_wd = input_dims->width;
+    const uint16_t input_ht = input_dims->height;
+    const uint16_t channels = input_dims->channels;
+    const int32_t input_offset = conv_params->in_offset;
+    const int32_t out_offset = conv_params->out_offset;
+    const uint16_t pad_wd = conv_params->padding.width;
+    const uint16_t pad_ht = conv_params->padding.height;
+    const uint16_t stride_wd = conv_params->stride.width;
+    const uint16_t stride_ht = conv_params->stride.height;
+    const int32_t dilation_wd = esp_nn_dilation(conv_params->dilation.width);
+    const int32_t dilation_ht = esp_nn_dilation(conv_params->dilation.height);
+    const uint16_t filter_wd = filter_dims->width;
+    const uint16_t filter_ht = filter_dims->height;
+    const uint16_t out_wd = output_dims->width;
+    const uint16_t out_ht = output_dims->height;
+    const int32_t activation_min = conv_params->activation.min;
+    const int32_t activation_max = conv_params->activation.max;
+
+    int out_idx = 0;
+    for (int out_y = 0; out_y < out_ht; out_y++) { //height loop
+        const int16_t base_y = (out_y * stride_ht) - pad_ht;
+        for (int out_x = 0; out_x < out_wd; out_x++) { //width_loop
+            const int16_t base_x = (out_x * stride_wd) - pad_wd;
+
+            const int32_t *out_shift = quant_data->shift;
+            const int32_t *out_mult = quant_data->mult;
+
+            /* Select filter so as the point doesn't lie outside block */
+            int filter_y_start = esp_nn_filter_tap_start(base_y, dilation_ht);
+            int filter_x_start = esp_nn_filter_tap_start(base_x, dilation_wd);
+            int filter_y_end = esp_nn_filter_tap_end(base_y, input_ht, filter_ht, dilation_ht);
+            int filter_x_end = esp_nn_filter_tap_end(base_x, input_wd, filter_wd, dilation_wd);
+
+            int ch_idx = 0;
+            for (; ch_idx < channels - 3; ch_idx += 4) {//channel_loop
+                int32_t result0 = 0;
+                int32_t result1 = 0;
+                int32_t result2 = 0;
+                int32_t result3 = 0;
+
+                for (int filter_y_idx = filter_y_start; filter_y_idx < filter_y_end; filter_y_idx++) {
+                    const int32_t idx_y = base_y + filter_y_idx * dilation_ht;
+                    for (int filter_x_idx = filter_x_start; filter_x_idx < filter_x_end; filter_x_idx++) {
+                        const int32_t idx_x = base_x + filter_x_idx * dilation_wd;
+                        int32_t input_index = (idx_y * input_wd + idx_x) * channels + ch_idx;
+                        int32_t filter_index = (filter_y_idx * filter_wd + filter_x_idx) * (channels) + ch_idx;
+                        int32_t input_val0 = input_data[input_index + 0] + input_offset;
+                        int32_t input_val1 = input_data[input_index + 1] + input_offset;
+                        int32_t input_val2 = input_data[input_index + 2] + input_offset;
+                        int32_t input_val3 = input_data[input_index + 3] + input_offset;
+                        int32_t filter_val0 = filter_data[filter_index + 0];
+                        int32_t filter_val1 = filter_data[filter_index + 1];
+                        int32_t filter_val2 = filter_data[filter_index + 2];
+                        int32_t filter_val3 = filter_data[filter_index + 3];
+                        result0 += input_val0 * filter_val0;
+                        result1 += input_val1 * filter_val1;
+                        result2 += input_val2 * filter_val2;
+                        result3 += input_val3 * filter_val3;
+                    }
+                }
+                if (bias) {
+                    result0 += bias[ch_idx + 0];
+                    result1 += bias[ch_idx + 1];
+                    result2 += bias[ch_idx + 2];
+                    result3 += bias[ch_idx + 3];
+                }
+                result0 = esp_nn_multiply_by_quantized_mult_fast(result0, *out_mult++, *out_shift++);
+                result1 = esp_nn_multiply_by_quantized_mult_fast(result1, *out_mult++, *out_shift++);
+                result2 = esp_nn_multiply_by_quantized_mult_fast(result2, *out_mult++, *out_shift++);
+                result3 = esp_nn_multiply_by_quantized_mult_fast(result3, *out_mult++, *out_shift++);
+
+                result0 += out_offset;
+                result1 += out_offset;
+                result2 += out_offset;
+                result3 += out_offset;
+
+                result0 = max(result0, activation_min);
+                result1 = max(result1, activation_min);
+                result2 = max(result2, activation_min);
+                result3 = max(result3, activation_min);
+
+                result0 = min(result0, activation_max);
+                result1 = min(result1, activation_max);
+                result2 = min(result2, activation_max);
+                result3 = min(result3, activation_max);
+
+                out_data[out_idx++] = result0;
+                out_data[out_idx++] = result1;
+                out_data[out_idx++] = result2;
+                out_data[out_idx++] = result3;
+            }
+            for (; ch_idx < channels; ch_idx++) {//channel_loop
+                int32_t result = 0;
+
+                for (int filter_y_idx = filter_y_start; filter_y_idx < filter_y_end; filter_y_idx++) {
+                    const int32_t idx_y = base_y + filter_y_idx * dilation_ht;
+                    for (int filter_x_idx = filter_x_start; filter_x_idx < filter_x_end; filter_x_idx++) {
+                        const int32_t idx_x = base_x + filter_x_idx * dilation_wd;
+                        int32_t input_index = (idx_y * input_wd + idx_x) * channels + ch_idx;
+                        int32_t filter_index = (filter_y_idx * filter_wd + filter_x_idx) * (channels) + ch_idx;
+                        int32_t input_val = input_data[input_index] + input_offset;
+                        int32_t filter_val = filter_data[filter_index];
+                        result += input_val * filter_val;
+                    }
+                }
+                if (bias) {
+                    result += bias[ch_idx];
+                }
+                result = esp_nn_multiply_by_quantized_mult_fast(result, *out_mult++, *out_shift++);
+                result += out_offset;
+                result = max(result, activation_min);
+                result = min(result, activation_max);
+
+                out_data[out_idx++] = result;
+            }
+        }
+    }
+}
+
+__NN_FORCE_INLINE__ int8_t esp_nn_depthwise_requant(int32_t result,
+                                                    const int32_t mult,
+                                                    const int32_t shift,
+                                                    const int32_t out_offset,
+                                                    const int32_t activation_min,
+                                                    const int32_t activation_max)
+{
+    result = esp_nn_multiply_by_quantized_mult_fast(result, mult, shift);
+    return (int8_t) min(max(result + out_offset, activation_min), activation_max);
+}
+
+/**
+ * One output pixel over (dilated) taps [filter_y_start, filter_y_end) x
+ * [filter_x_start, filter_x_end), with `fold` holding the offset/bias term
+ * for exactly those taps. Used for the border and for interiors with no
+ * specialized kernel.
+ */
+__NN_FORCE_INLINE__ void esp_nn_depthwise_conv_s8_pixel(const int8_t *input_data,
+                                                        const uint16_t input_wd,
+                                                        const uint16_t channels,
+                                                        const uint16_t ch_mult,
+                                                        const int8_t *filter_data,
+                                                        const uint16_t filter_wd,
+                                                        const int32_t dilation_wd,
+                                                        const int32_t dilation_ht,
+                                                        const int32_t base_y,
+                                                        const int32_t base_x,
+                                                        const int32_t filter_y_start,
+                                                        const int32_t filter_y_end,
+                                                        const int32_t filter_x_start,
+                                                        const int32_t filter_x_end,
+                                                        const int32_t *fold,
+                                                        int8_t *out_data,
+                                                        const dw_conv_params_t *conv_params,
+                                                        const quant_data_t *quant_data)
+{
+    const uint16_t out_channels = channels * ch_mult;
+    const int32_t out_offset = conv_params->out_offset;
+    const int32_t activation_min = conv_params->activation.min;
+    const int32_t activation_max = conv_params->activation.max;
+    const int32_t *out_shift = quant_data->shift;
+    const int32_t *out_mult = quant_data->mult;
+
+    if (ch_mult == 1) {
+        int ch_idx = 0;
+        for (; ch_idx < channels - 3; ch_idx += 4) {//channel_loop
+            int32_t result0 = fold[ch_idx + 0];
+            int32_t result1 = fold[ch_idx + 1];
+            int32_t result2 = fold[ch_idx + 2];
+            int32_t result3 = fold[ch_idx + 3];
+
+            for (int filter_y_idx = filter_y_start; filter_y_idx < filter_y_end; filter_y_idx++) {
+                const int32_t idx_y = base_y + filter_y_idx * dilation_ht;
+                for (int filter_x_idx = filter_x_start; filter_x_idx < filter_x_end; filter_x_idx++) {
+                    const int32_t idx_x = base_x + filter_x_idx * dilation_wd;
+                    const int8_t *input_ptr = input_data + (idx_y * input_wd + idx_x) * channels + ch_idx;
+                    const int8_t *filter_ptr = filter_data +
+                                    (filter_y_idx * filter_wd + filter_x_idx) * channels + ch_idx;
+                    result0 += input_ptr[0] * filter_ptr[0];
+                    result1 += input_ptr[1] * filter_ptr[1];
+                    result2 += input_ptr[2] * filter_ptr[2];
+                    result3 += input_ptr[3] * filter_ptr[3];
+                }
+            }
+            out_data[ch_idx + 0] = esp_nn_depthwise_requant(result0, out_mult[ch_idx + 0], out_shift[ch_idx + 0],
+                                                            out_offset, activation_min, activation_max);
+            out_data[ch_idx + 1] = esp_nn_depthwise_requant(result1, out_mult[ch_idx + 1], out_shift[ch_idx + 1],
+                                                            out_offset, activation_min, activation_max);
+            out_data[ch_idx + 2] = esp_nn_depthwise_requant(result2, out_mult[ch_idx + 2], out_shift[ch_idx + 2],
+                                                            out_offset, activation_min, activation_max);
+            out_data[ch_idx + 3] = esp_nn_depthwise_requant(result3, out_mult[ch_idx + 3], out_shift[ch_idx + 3],
+                                                            out_offset, activation_min, activation_max);
+        }
+        for (; ch_idx < channels; ch_idx++) {//channel_loop
+            int32_t result = fold[ch_idx];
+
+            for (int filter_y_idx = filter_y_start; filter_y_idx < filter_y_end; filter_y_idx++) {
+                const int32_t idx_y = base_y + filter_y_idx * dilation_ht;
+                for (int filter_x_idx = filter_x_start; filter_x_idx < filter_x_end; filter_x_idx++) {
+                    const int32_t idx_x = base_x + filter_x_idx * dilation_wd;
+                    int32_t input_index = (idx_y * input_wd + idx_x) * channels + ch_idx;
+                    int32_t filter_index = (filter_y_idx * filter_wd + filter_x_idx) * channels + ch_idx;
+                    result += input_data[input_index] * filter_data[filter_index];
+                }
+            }
+            out_data[ch_idx] = esp_nn_depthwise_requant(result, out_mult[ch_idx], out_shift[ch_idx],
+                                                        out_offset, activation_min, activation_max);
+        }
+        return;
+    }
+
+    for (int ch_idx = 0; ch_idx < channels; ch_idx++) {//channel_loop
+        int ch_mult_idx = 0;
+        for (; ch_mult_idx < ch_mult - 3; ch_mult_idx += 4) {
+            const int out_ch_idx =  ch_idx * ch_mult + ch_mult_idx;
+            int32_t result0 = fold[out_ch_idx + 0];
+            int32_t result1 = fold[out_ch_idx + 1];
+            int32_t result2 = fold[out_ch_idx + 2];
+            int32_t result3 = fold[out_ch_idx + 3];
+
+            for (int filter_y_idx = filter_y_start; filter_y_idx < filter_y_end; filter_y_idx++) {
+                const int32_t idx_y = base_y + filter_y_idx * dilation_ht;
+                for (int filter_x_idx = filter_x_start; filter_x_idx < filter_x_end; filter_x_idx++) {
+                    const int32_t idx_x = base_x + filter_x_idx * dilation_wd;
+                    int32_t input_index = (idx_y * input_wd + idx_x) * channels + ch_idx;
+                    const int8_t *filter_ptr = filter_data +
+                                    (filter_y_idx * filter_wd + filter_x_idx) * out_channels + out_ch_idx;
+                    int32_t input_val = input_data[input_index];
+                    result0 += input_val * filter_ptr[0];
+                    result1 += input_val * filter_ptr[1];
+                    result2 += input_val * filter_ptr[2];
+                    result3 += input_val * filter_ptr[3];
+                }
+            }
+            out_data[out_ch_idx + 0] = esp_nn_depthwise_requant(result0, out_mult[out_ch_idx + 0], out_shift[out_ch_idx + 0],
+                                                                out_offset, activation_min, activation_max);
+            out_data[out_ch_idx + 1] = esp_nn_depthwise_requant(result1, out_mult[out_ch_idx + 1], out_shift[out_ch_idx + 1],
+                                                                out_offset, activation_min, activation_max);
+            out_data[out_ch_idx + 2] = esp_nn_depthwise_requant(result2, out_mult[out_ch_idx + 2], out_shift[out_ch_idx + 2],
+                                                                out_offset, activation_min, activation_max);
+            out_data[out_ch_idx + 3] = esp_nn_depthwise_requant(result3, out_mult[out_ch_idx + 3], out_shift[out_ch_idx + 3],
+                                                                out_offset, activation_min, activation_max);
+        }
+        for (; ch_mult_idx < ch_mult; ch_mult_idx++) {
+            const int out_ch_idx =  ch_idx * ch_mult + ch_mult_idx;
+            int32_t result = fold[out_ch_idx];
+
+            for (int filter_y_idx = filter_y_start; filter_y_idx < filter_y_end; filter_y_idx++) {
+                const int32_t idx_y = base_y + filter_y_idx * dilation_ht;
+                for (int filter_x_idx = filter_x_start; filter_x_idx < filter_x_end; filter_x_idx++) {
+                    const int32_t idx_x = base_x + filter_x_idx * dilation_wd;
+                    int32_t input_index = (idx_y * input_wd + idx_x) * channels + ch_idx;
+                    int32_t filter_index = (filter_y_idx * filter_wd + filter_x_idx) * out_channels + out_ch_idx;
+                    result += input_data[input_index] * filter_data[filter_index];
+                }
+            }
+            out_data[out_ch_idx] = esp_nn_depthwise_requant(result, out_mult[out_ch_idx], out_shift[out_ch_idx],
+                                                            out_offset, activation_min, activation_max);
+        }
+    }
+}
+
+/**
+ * A run of `n_pix` interior pixels of one output row for ch_mult == 1.
+ * `filter_size` and `stride` are compile-time constants at every call site,
+ * so the tap loops fully unroll; the row pointers are set up once per run
+ * and step by `stride` pixels, with no bounds clamping. Dilation only
+ * scales the tap steps.
+ */
+__NN_FORCE_INLINE__ void esp_nn_depthwise_interior_mult1(const int8_t *input_data,
+                                                         const uint16_t input_wd,
+                                                         const uint16_t channels,
+                                                         const int8_t *filter_data,
+                                                         const int32_t *fold,
+                                                         const int32_t base_y,
+                                                         const int32_t base_x,
+                                                         const int32_t n_pix,
+                                                         const int32_t filter_size,
+                                                         const int32_t stride,
+                                                         const int32_t dilation_wd,
+                                                         const int32_t dilation_ht,
+                                                         int8_t *out_data,
+                                                         const dw_conv_params_t *conv_params,
+                                                         const quant_data_t *quant_data)
+{
+    const int32_t out_offset = conv_params->out_offset;
+    const int32_t activation_min = conv_params->activation.min;
+    const int32_t activation_max = conv_params->activation.max;
+    const int32_t *out_shift = quant_data->shift;
+    const int32_t *out_mult = quant_data->mult;
+    const int32_t row_step = dilation_ht * input_wd * channels;
+    const int32_t tap_step = dilation_wd * channels;
+    const int32_t filter_row_step = filter_size * channels;
+    const int8_t *input_row = input_data + (base_y * input_wd + base_x) * channels;
+
+    for (int32_t pix = 0; pix < n_pix; pix++) {
+        int ch_idx = 0;
+        for (; ch_idx < channels - 3; ch_idx += 4) {
+            int32_t result0 = fold[ch_idx + 0];
+            int32_t result1 = fold[ch_idx + 1];
+            int32_t result2 = fold[ch_idx + 2];
+            int32_t result3 = fold[ch_idx + 3];
+
+            for (int32_t filter_y_idx = 0; filter_y_idx < filter_size; filter_y_idx++) {
+                const int8_t *input_ptr = input_row + filter_y_idx * row_step + ch_idx;
+                const int8_t *filter_ptr = filter_data + filter_y_idx * filter_row_step + ch_idx;
+                for (int32_t filter_x_idx = 0; filter_x_idx < filter_size; filter_x_idx++) {
+                    result0 += input_ptr[0] * filter_ptr[0];
+                    result1 += input_ptr[1] * filter_ptr[1];
+                    result2 += input_ptr[2] * filter_ptr[2];
+                    result3 += input_ptr[3] * filter_ptr[3];
+                    input_ptr += tap_step;
+                    filter_ptr += channels;
+                }
+            }
+            out_data[ch_idx + 0] = esp_nn_depthwise_requant(result0, out_mult[ch_idx + 0], out_shift[ch_idx + 0],
+                                                            out_offset, activation_min, activation_max);
+            out_data[ch_idx + 1] = esp_nn_depthwise_requant(result1, out_mult[ch_idx + 1], out_shift[ch_idx + 1],
+                                                            out_offset, activation_min, activation_max);
+            out_data[ch_idx + 2] = esp_nn_depthwise_requant(result2, out_mult[ch_idx + 2], out_shift[ch_idx + 2],
+                                                            out_offset, activation_min, activation_max);
+            out_data[ch_idx + 3] = esp_nn_depthwise_requant(result3, out_mult[ch_idx + 3], out_shift[ch_idx + 3],
+                                                            out_offset, activation_min, activation_max);
+        }
+        for (; ch_idx < channels; ch_idx++) {
+            int32_t result = fold[ch_idx];
+
+            for (int32_t filter_y_idx = 0; filter_y_idx < filter_size; filter_y_idx++) {
+                const int8_t *input_ptr = input_row + filter_y_idx * row_step + ch_idx;
+                const int8_t *filter_ptr = filter_data + filter_y_idx * filter_row_step + ch_idx;
+                for (int32_t filter_x_idx = 0; filter_x_idx < filter_size; filter_x_idx++) {
+                    result += *input_ptr * *filter_ptr;
+                    input_ptr += tap_step;
+                    filter_ptr += channels;
+                }
+            }
+            out_data[ch_idx] = esp_nn_depthwise_requant(result, out_mult[ch_idx], out_shift[ch_idx],
+                                                        out_offset, activation_min, activation_max);
+        }
+        input_row += stride * channels;
+        out_data += channels;
+    }
+}
+
+/**
+ * Depthwise conv with the offset/bias term folded into the scratch buffer.
+ *
+ * Output pixels whose window lies fully inside the input (the interior) need
+ * no clipping: each interior row run goes to an unrolled 3x3/5x5,
+ * stride 1/2 kernel for ch_mult == 1, or to the generic pixel loop with the
+ * full window otherwise. Only border pixels compute clipped bounds; they get
+ * their own fold, recomputed only when the clipped window changes.
+ */
+__attribute__ ((noinline))
+static void esp_nn_depthwise_conv_s8_folded(const data_dims_t *input_dims,
+                                            const int8_t *input_data,
+                                            const data_dims_t *filter_dims,
+                                            const int8_t *filter_data,
+                                            const int32_t *bias,
+                                            const data_dims_t *output_dims,
+                                            int8_t *out_data,
+                                            const dw_conv_params_t *conv_params,
+                                            const quant_data_t *quant_data)
+{
+    const uint16_t input_wd = input_dims->width;
+    const uint16_t input_ht = input_dims->height;
+    const uint16_t channels = input_dims->channels;
+    const uint16_t ch_mult = conv_params->ch_mult;
+    const int32_t input_offset = conv_params->in_offset;
+    const uint16_t pad_wd = conv_params->padding.width;
+    const uint16_t pad_ht = conv_params->padding.height;
+    const uint16_t stride_wd = conv_params->stride.width;
+    const uint16_t stride_ht = conv_params->stride.height;
+    const int32_t dilation_wd = esp_nn_dilation(conv_params->dilation.width);
+    const int32_t dilation_ht = esp_nn_dilation(conv_params->dilation.height);
+    const uint16_t filter_wd = filter_dims->width;
+    const uint16_t filter_ht = filter_dims->height;
+    const uint16_t out_wd = output_dims->width;
+    const uint16_t out_ht = output_dims->height;
+    const uint16_t out_channels = channels * ch_mult;
+
+    int32_t *full_fold = scratch_buffer;
+    int32_t *border_fold = scratch_buffer + out_channels;
+    int32_t border_key = -1;
+
+    esp_nn_depthwise_fold_offset_bias(filter_data, bias, filter_wd, out_channels,
+                                      0, filter_ht, 0, filter_wd, input_offset, full_fold);
+
+    /* interior: out_y in [y_start, y_end), out_x in [x_start, x_end) */
+    const int32_t extent_ht = (filter_ht - 1) * dilation_ht + 1;
+    const int32_t extent_wd = (filter_wd - 1) * dilation_wd + 1;
+    const int32_t y_start = min(out_ht, (pad_ht + stride_ht - 1) / stride_ht);
+    const int32_t x_start = min(out_wd, (pad_wd + stride_wd - 1) / stride_wd);
+    int32_t y_end = 0, x_end = 0;
+    if (input_ht + pad_ht >= extent_ht) {
+        y_end = min(out_ht, (input_ht + pad_ht - extent_ht) / stride_ht + 1);
+    }
+    if (input_wd + pad_wd >= extent_wd) {
+        x_end = min(out_wd, (input_wd + pad_wd - extent_wd) / stride_wd + 1);
+    }
+    y_end = max(y_end, y_start);
+    x_end = max(x_end, x_start);
+
+    /* interior kernel with constant trip counts, if one fits this layer */
+    int32_t unrolled = 0;
+    if (ch_mult == 1 && filter_wd == filter_ht && stride_wd == stride_ht &&
+            (filter_wd == 3 || filter_wd == 5) && (stride_wd == 1 || stride_wd == 2)) {
+        unrolled = filter_wd * 10 + stride_wd;
+    }
+
+    for (int out_y = 0; out_y < out_ht; out_y++) { //height loop
+        const int32_t base_y = (out_y * stride_ht) - pad_ht;
+        const int interior_row = out_y >= y_start && out_y < y_end;
+        int8_t *out_row = out_data + out_y * out_wd * out_channels;
+
+        for (int out_x = 0; out_x < out_wd; out_x++) { //width_loop
+            const int32_t base_x = (out_x * stride_wd) - pad_wd;
+
+            if (interior_row && out_x == x_start && x_end > x_start) {
+                const int32_t n_pix = x_end - x_start;
+                int8_t *out_ptr = out_row + out_x * out_channels;
+                switch (unrolled) {
+                case 31:
+                    esp_nn_depthwise_interior_mult1(input_data, input_wd, channels, filter_data, full_fold,
+                                                    base_y, base_x, n_pix, 3, 1, dilation_wd, dilation_ht,
+                                                    out_ptr, conv_params, quant_data);
+                    break;
+                case 32:
+                    esp_nn_depthwise_interior_mult1(input_data, input_wd, channels, filter_data, full_fold,
+                                                    base_y, base_x, n_pix, 3, 2, dilation_wd, dilation_ht,
+                                                    out_ptr, conv_params, quant_data);
+                    break;
+                case 51:
+                    esp_nn_depthwise_interior_mult1(input_data, input_wd, channels, filter_data, full_fold,
+                                                    base_y, base_x, n_pix, 5, 1, dilation_wd, dilation_ht,
+                                                    out_ptr, conv_params, quant_data);
+                    break;
+                case 52:
+                    esp_nn_depthwise_interior_mult1(input_data, input_wd, channels, filter_data, full_fold,
+                                                    base_y, base_x, n_pix, 5, 2, dilation_wd, dilation_ht,
+                                                    out_ptr, conv_params, quant_data);
+                    break;
+                default:
+                    for (int32_t pix = 0; pix < n_pix; pix++) {
+                        esp_nn_depthwise_conv_s8_pixel(input_data, input_wd, channels, ch_mult,
+                                                       filter_data, filter_wd, dilation_wd, dilation_ht, base_y,
+                                                       base_x + pix * stride_wd, 0, filter_ht, 0, filter_wd,
+                                                       full_fold, out_ptr + pix * out_channels,
+                                                       conv_params, quant_data);
+                    }
+                    break;
+                }
+                out_x = x_end - 1;
+                continue;
+            }
+
+            /* Select filter so as the point doesn't lie outside block */
+            const int32_t filter_y_start = esp_nn_filter_tap_start(base_y, dilation_ht);
+            const int32_t filter_x_start = esp_nn_filter_tap_start(base_x, dilation_wd);
+            const int32_t filter_y_end = esp_nn_filter_tap_end(base_y, input_ht, filter_ht, dilation_ht);
+            const int32_t filter_x_end = esp_nn_filter_tap_end(base_x, input_wd, filter_wd, dilation_wd);
+
+            /* the window bounds fit in 8 bits each for any real filter */
+            const int32_t key = (filter_y_start << 24) | (filter_y_end << 16) |
+                                (filter_x_start << 8) | filter_x_end;
+            if (key != border_key) {
+                esp_nn_depthwise_fold_offset_bias(filter_data, bias, filter_wd, out_channels,
+                                                  filter_y_start, filter_y_end,
+                                                  filter_x_start, filter_x_end,
+                                                  input_offset, border_fold);
+                border_key = key;
+            }
+            esp_nn_depthwise_conv_s8_pixel(input_data, input_wd, channels, ch_mult, filter_data, filter_wd,
+                                           dilation_wd, dilation_ht, base_y, base_x, filter_y_start, filter_y_end,
+                                           filter_x_start, filter_x_end, border_fold,
+                                           out_row + out_x * out_channels, conv_params, quant_data);
+        }
+    }
+}
+
+void esp_nn_depthwise_conv_s8_opt(const data_dims_t *input_dims,
+                                  const int8_t *input_data,
+                                  const data_dims_t *filter_dims,
+                                  const int8_t *filter_data,
+                                  const int32_t *bias,
+                                  const data_dims_t *output_dims,
+                                  int8_t *out_data,
+                                  const dw_conv_params_t *conv_params,
+                                  const quant_data_t *quant_data)
+{
+    if (scratch_buffer) {
+        esp_nn_depthwise_conv_s8_folded(input_dims, input_data, filter_dims, filter_data,
+                                        bias, output_dims, out_data, conv_params, quant_data);
+        return;
+    }
+    const uint16_t ch_mult = conv_params->ch_mult;
+    if (ch_mult == 1) {
+        esp_nn_depthwise_conv_s8_ch_mult_1(input_dims, input_data, filter_dims, filter_data,
+                                           bias, output_dims, out_data, conv_params, quant_data);
+        return;
+    }
+    const uint16_t input_wd = input_dims->width;
+    const uint16_t input_ht = input_dims->height;
+    const uint16_t channels = input_dims->channels;
+    const int32_t input_offset = conv_params->in_offset;
+    const int32_t out_offset = conv_params->out_offset;
+    const uint16_t pad_wd = conv_params->padding.width;
+    const uint16_t pad_ht = conv_params->padding.height;
+    const uint16_t stride_wd = conv_params->stride.width;
+    const uint16_t stride_ht = conv_params->stride.height;
+    const int32_t dilation_wd = esp_nn_dilation(conv_params->dilation.width);
+    const int32_t dilation_ht = esp_nn_dilation(conv_params->dilation.height);
+    const uint16_t filter_wd = filter_dims->width;
+    const uint16_t filter_ht = filter_dims->height;
+    const uint16_t out_wd = output_dims->width;
+    const uint16_t out_ht = output_dims->height;
+    const int32_t activation_min = conv_params->activation.min;
+    const int32_t activation_max = conv_params->activation.max;
+
+    int out_idx = 0;
+    for (int out_y = 0; out_y < out_ht; out_y++) { //height loop
+        const int16_t base_y = (out_y * stride_ht) - pad_ht;
+        for (int out_x = 0; out_x < out_wd; out_x++) { //width_loop
+            const int16_t base_x = (out_x * stride_wd) - pad_wd;
+
+            const int32_t *out_shift = quant_data->shift;
+            const int32_t *out_mult = quant_data->mult;
+
+            /* Select filter so as the point doesn't lie outside block */
+            int filter_y_start = esp_nn_filter_tap_start(base_y, dilation_ht);
+            int filter_x_start = esp_nn_filter_tap_start(base_x, dilation_wd);
+            int filter_y_end = esp_nn_filter_tap_end(base_y, input_ht, filter_ht, dilation_ht);
+            int filter_x_end = esp_nn_filter_tap_end(base_x, input_wd, filter_wd, dilation_wd);
+
+            for (int ch_idx = 0; ch_idx < channels; ch_idx++) {//channel_loop
+                int ch_mult_idx = 0;
+                for (; ch_mult_idx < ch_mult - 3; ch_mult_idx += 4) {
+                    int32_t result0 = 0;
+                    int32_t result1 = 0;
+                    int32_t result2 = 0;
+                    int32_t result3 = 0;
+                    const int out_ch_idx =  ch_idx * ch_mult + ch_mult_idx;
+
+                    for (int filter_y_idx = filter_y_start; filter_y_idx < filter_y_end; filter_y_idx++) {
+                        const int32_t idx_y = base_y + filter_y_idx * dilation_ht;
+                        for (int filter_x_idx = filter_x_start; filter_x_idx < filter_x_end; filter_x_idx++) {
+                            const int32_t idx_x = base_x + filter_x_idx * dilation_wd;
+                            int32_t input_index = (idx_y * input_wd + idx_x) * channels + ch_idx;
+                            int32_t filter_index = (filter_y_idx * filter_wd + filter_x_idx) * (channels * ch_mult) + out_ch_idx;
+                            int32_t input_val = input_data[input_index] + input_offset;
+                            int32_t filter_val0 = filter_data[filter_index + 0];
+                            int32_t filter_val1 = filter_data[filter_index + 1];
+                            int32_t filter_val2 = filter_data[filter_index + 2];
+                            int32_t filter_val3 = filter_data[filter_index + 3];
+                            result0 += input_val * filter_val0;
+                            result1 += input_val * filter_val1;
+                            result2 += input_val * filter_val2;
+                            result3 += input_val * filter_val3;
+                        }
+                    }
+                    if (bias) {
+                        result0 += bias[out_ch_idx + 0];
+                        result1 += bias[out_ch_idx + 1];
+                        result2 += bias[out_ch_idx + 2];
+                        result3 += bias[out_ch_idx + 3];
+                    }
+                    result0 = esp_nn_multiply_by_quantized_mult_fast(result0, *out_mult++, *out_shift++);
+                    result1 = esp_nn_multiply_by_quantized_mult_fast(result1, *out_mult++, *out_shift++);
+                    result2 = esp_nn_multiply_by_quantized_mult_fast(result2, *out_mult++, *out_shift++);
+                    result3 = esp_nn_multiply_by_quantized_mult_fast(result3, *out_mult++, *out_shift++);
+
+                    result0 += out_offset;
+                    result1 += out_offset;
+                    result2 += out_offset;
+                    result3 += out_offset;
+
+                    result0 = max(result0, activation_min);
+                    result1 = max(result1, activation_min);
+                    result2 = max(result2, activation_min);
+                    result3 = max(result3, activation_min);
+                    result0 = min(result0, activation_max);
+                    result1 = min(result1, activation_max);
+                    result2 = min(result2, activation_max);
+                    result3 = min(result3, activation_max);
+
+                    out_data[out_idx++] = result0;
+                    out_data[out_idx++] = result1;
+                    out_data[out_idx++] = result2;
+                    out_data[out_idx++] = result3;
+                }
+                for (; ch_mult_idx < ch_mult; ch_mult_idx++) {
+                    int32_t result = 0;
+                    const int out_ch_idx =  ch_idx * ch_mult + ch_mult_idx;
+
+                    for (int filter_y_idx = filter_y_start; filter_y_idx < filter_y_end; filter_y_idx++) {
+                        const int32_t idx_y = base_y + filter_y_idx * dilation_ht;
+                        for (int filter_x_idx = filter_x_start; filter_x_idx < filter_x_end; filter_x_idx++) {
+                            const int32_t idx_x = base_x + filter_x_idx * dilation_wd;
+                            int32_t input_index = (idx_y * input_wd + idx_x) * channels + ch_idx;
+                            int32_t filter_index = (filter_y_idx * filter_wd + filter_x_idx) * (channels * ch_mult) + out_ch_idx;
+                            int32_t input_val = input_data[input_index] + input_offset;
+                            int32_t filter_val = filter_data[filter_index];
+                            result += input_val * filter_val;
+                        }
+                    }
+                    if (bias) {
+                        result += bias[out_ch_idx];
+                    }
+                    result = esp_nn_multiply_by_quantized_mult_fast(result, *out_mult++, *out_shift++);
+                    result += out_offset;
+                    result = max(result, activation_min);
+                    result = min(result, activation_max);
+
+                    out_data[out_idx++] = result;
+                }
+            }
+        }
+    }
+}
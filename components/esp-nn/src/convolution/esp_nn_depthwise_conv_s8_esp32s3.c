@@ -14,6 +14,7 @@
 
 #include <stdio.h>
 #include <esp_nn_defs.h>
+#include <esp_nn_ansi_headers.h>
 
 #include <common_functions.h>
 
@@ -358,6 +359,10 @@ int esp_nn_get_depthwise_conv_scratch_size_esp32s3(const data_dims_t *input_dims
                                                    const data_dims_t *output_dims,
                                                    const dw_conv_params_t *conv_params)
 {
+    if (esp_nn_is_dilated(filter_dims->width, filter_dims->height,
+                          conv_params->dilation.width, conv_params->dilation.height)) {
+        return esp_nn_get_depthwise_conv_scratch_size_opt(input_dims, filter_dims, output_dims, conv_params);
+    }
     const uint16_t input_wd = input_dims->width;
     const uint16_t input_ht = input_dims->height;
     const uint16_t channels = input_dims->channels;
@@ -416,7 +421,7 @@ void esp_nn_set_depthwise_conv_scratch_buf_esp32s3(void *buf)
 /**
  * Assumption 1: i/p channels == o/p channels
  * Assumption 2: Pointers are valid
- * Assumption 3: dialation width = 1
+ * Dilated filters are handed to the generic kernel.
  */
 
 
@@ -431,6 +436,15 @@ void esp_nn_depthwise_conv_s8_esp32s3(const data_dims_t *input_dims,
                                       const dw_conv_params_t *conv_params,
                                       const quant_data_t *quant_data)
 {
+    if (esp_nn_is_dilated(filter_dims->width, filter_dims->height,
+                          conv_params->dilation.width, conv_params->dilation.height)) {
+        /* generic kernel, on the scratch sized for it by get_scratch_size */
+        esp_nn_set_depthwise_conv_scratch_buf_opt(scratch_buffer);
+        esp_nn_depthwise_conv_s8_opt(input_dims, input_data, filter_dims, filter_data, bias,
+                                     output_dims, out_data, conv_params, quant_data);
+        esp_nn_set_depthwise_conv_scratch_buf_opt(NULL);
+        return;
+    }
     const uint16_t input_wd = input_dims->width;
     const uint16_t input_ht = input_dims->height;
     const uint16_t channels = input_dims->channels;
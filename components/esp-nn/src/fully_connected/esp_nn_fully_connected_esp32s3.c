@@ -0,0 +1,44 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <stdint.h>
+
+#include <esp_nn_esp32s3.h>
+
+/**
+ * Row loop over the SIMD single-row kernel, so batching never falls back
+ * to the generic C kernel on this target.
+ */
+void esp_nn_fully_connected_batch_s8_esp32s3(const int8_t *input_data,
+                                             const int32_t input_offset,
+                                             const uint16_t row_len,
+                                             const uint16_t batches,
+                                             const int8_t *filter_data,
+                                             const int32_t filter_offset,
+                                             const int32_t *bias,
+                                             int8_t *out_data,
+                                             const uint16_t out_channels,
+                                             const int32_t out_offset,
+                                             const int32_t out_shift,
+                                             const int32_t out_mult,
+                                             const int32_t activation_min,
+                                             const int32_t activation_max)
+{
+    for (int32_t b = 0; b < batches; b++) {
+        esp_nn_fully_connected_s8_esp32s3(input_data + b * row_len, input_offset, row_len,
+                                          filter_data, filter_offset, bias,
+                                          out_data + b * out_channels, out_channels, out_offset,
+                                          out_shift, out_mult, activation_min, activation_max);
+    }
+}
@@ -0,0 +1,185 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <stdint.h>
+
+#include <common_functions.h>
+
+__NN_FORCE_INLINE__ int8_t esp_nn_fully_connected_requant(int32_t acc,
+                                                         const int32_t out_mult,
+                                                         const int32_t out_shift,
+                                                         const int32_t out_offset,
+                                                         const int32_t activation_min,
+                                                         const int32_t activation_max)
+{
+    int32_t result = esp_nn_multiply_by_quantized_mult_fast(acc, out_mult, out_shift);
+    result += out_offset;
+    result = max(result, activation_min);
+    result = min(result, activation_max);
+    return (int8_t) result;
+}
+
+/**
+ * filter_offset * sum(input + input_offset), the same for every filter row
+ */
+__NN_FORCE_INLINE__ int32_t esp_nn_fully_connected_row_const(const int8_t *input_data,
+                                                             const int32_t input_offset,
+                                                             const uint16_t row_len,
+                                                             const int32_t filter_offset)
+{
+    if (filter_offset == 0) {
+        return 0;
+    }
+    int32_t input_sum = 0;
+    for (int32_t i = 0; i < row_len; i++) {
+        input_sum += input_data[i];
+    }
+    return filter_offset * (input_sum + row_len * input_offset);
+}
+
+/**
+ * (filter + filter_offset) * (input + input_offset) is split as
+ * filter * (input + input_offset) + filter_offset * (input + input_offset).
+ * The second term sums to the same constant for every row, so it is computed
+ * once per call and folded into the bias. The first is accumulated four rows
+ * at a time, so each offset input is loaded once per four output channels.
+ *
+ * `mult_step` is 0 for per-tensor and 1 for per-channel requantization.
+ */
+__NN_FORCE_INLINE__ void esp_nn_fully_connected_s8_opt_core(const int8_t *input_data,
+                                                            const int32_t input_offset,
+                                                            const uint16_t row_len,
+                                                            const int8_t *filter_data,
+                                                            const int32_t filter_offset,
+                                                            const int32_t *bias,
+                                                            int8_t *out_data,
+                                                            const uint16_t out_channels,
+                                                            const int32_t out_offset,
+                                                            const int32_t *out_shift,
+                                                            const int32_t *out_mult,
+                                                            const int32_t mult_step,
+                                                            const int32_t activation_min,
+                                                            const int32_t activation_max)
+{
+    const int32_t row_const = esp_nn_fully_connected_row_const(input_data, input_offset,
+                                                               row_len, filter_offset);
+
+    int32_t out_c = 0;
+    for (; out_c < out_channels - 3; out_c += 4) {
+        const int8_t *filter_0 = filter_data + out_c * row_len;
+        const int8_t *filter_1 = filter_0 + row_len;
+        const int8_t *filter_2 = filter_1 + row_len;
+        const int8_t *filter_3 = filter_2 + row_len;
+        int32_t acc[4] = {row_const, row_const, row_const, row_const};
+
+        for (int32_t i = 0; i < row_len; i++) {
+            int32_t input_val = input_data[i] + input_offset;
+            acc[0] += filter_0[i] * input_val;
+            acc[1] += filter_1[i] * input_val;
+            acc[2] += filter_2[i] * input_val;
+            acc[3] += filter_3[i] * input_val;
+        }
+
+        for (int32_t k = 0; k < 4; k++) {
+            int32_t ch = out_c + k;
+            int32_t result = acc[k];
+            if (bias) {
+                result += bias[ch];
+            }
+            out_data[ch] = esp_nn_fully_connected_requant(result, out_mult[ch * mult_step],
+                                                          out_shift[ch * mult_step], out_offset,
+                                                          activation_min, activation_max);
+        }
+    }
+
+    for (; out_c < out_channels; out_c++) {
+        const int8_t *filter = filter_data + out_c * row_len;
+        int32_t result = row_const;
+        for (int32_t i = 0; i < row_len; i++) {
+            result += filter[i] * (input_data[i] + input_offset);
+        }
+        if (bias) {
+            result += bias[out_c];
+        }
+        out_data[out_c] = esp_nn_fully_connected_requant(result, out_mult[out_c * mult_step],
+                                                         out_shift[out_c * mult_step], out_offset,
+                                                         activation_min, activation_max);
+    }
+}
+
+void esp_nn_fully_connected_s8_opt(const int8_t *input_data,
+                                   const int32_t input_offset,
+                                   const uint16_t row_len,
+                                   const int8_t *filter_data,
+                                   const int32_t filter_offset,
+                                   const int32_t *bias,
+                                   int8_t *out_data,
+                                   const uint16_t out_channels,
+                                   const int32_t out_offset,
+                                   const int32_t out_shift,
+                                   const int32_t out_mult,
+                                   const int32_t activation_min,
+                                   const int32_t activation_max)
+{
+    esp_nn_fully_connected_s8_opt_core(input_data, input_offset, row_len, filter_data,
+                                       filter_offset, bias, out_data, out_channels, out_offset,
+                                       &out_shift, &out_mult, 0, activation_min, activation_max);
+}
+
+void esp_nn_fully_connected_per_ch_s8_opt(const int8_t *input_data,
+                                          const int32_t input_offset,
+                                          const uint16_t row_len,
+                                          const int8_t *filter_data,
+                                          const int32_t filter_offset,
+                                          const int32_t *bias,
+                                          int8_t *out_data,
+                                          const uint16_t out_channels,
+                                          const int32_t out_offset,
+                                          const int32_t *out_shift,
+                                          const int32_t *out_mult,
+                                          const int32_t activation_min,
+                                          const int32_t activation_max)
+{
+    esp_nn_fully_connected_s8_opt_core(input_data, input_offset, row_len, filter_data,
+                                       filter_offset, bias, out_data, out_channels, out_offset,
+                                       out_shift, out_mult, 1, activation_min, activation_max);
+}
+
+/**
+ * One row at a time through the single-row kernel. A blocked version that
+ * swept filter tiles over several rows measured slower than this on the
+ * host and was never shown faster on a target.
+ */
+void esp_nn_fully_connected_batch_s8_opt(const int8_t *input_data,
+                                         const int32_t input_offset,
+                                         const uint16_t row_len,
+                                         const uint16_t batches,
+                                         const int8_t *filter_data,
+                                         const int32_t filter_offset,
+                                         const int32_t *bias,
+                                         int8_t *out_data,
+                                         const uint16_t out_channels,
+                                         const int32_t out_offset,
+                                         const int32_t out_shift,
+                                         const int32_t out_mult,
+                                         const int32_t activation_min,
+                                         const int32_t activation_max)
+{
+    for (int32_t b = 0; b < batches; b++) {
+        esp_nn_fully_connected_s8_opt(input_data + b * row_len, input_offset, row_len,
+                                      filter_data, filter_offset, bias,
+                                      out_data + b * out_channels, out_channels, out_offset,
+                                      out_shift, out_mult, activation_min, activation_max);
+    }
+}
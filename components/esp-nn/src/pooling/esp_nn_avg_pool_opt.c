@@ -0,0 +1,235 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <stdint.h>
+
+#include <common_functions.h>
+
+/* channels summed in one pass; the running sums live on the stack */
+#define AVG_POOL_CH_BLOCK       32
+
+/* largest window size with an exact reciprocal below, larger ones divide */
+#define AVG_POOL_RECIP_MAX_CNT  (1 << 20)
+
+typedef struct {
+    int32_t cnt;
+    int32_t half;
+    uint32_t mult;
+    int32_t shift;
+    bool narrow;    /* (n * mult) fits in 32 bits for every n below */
+} avg_pool_recip_t;
+
+/**
+ * @brief   Reciprocal of `cnt` such that `(n * mult) >> shift == n / cnt`
+ *
+ * @note    Exact as long as `n * cnt < 2^shift`. n is at most
+ *          `128 * cnt + cnt / 2`: the largest |sum| of cnt int8 values plus
+ *          the rounding term.
+ */
+static void esp_nn_avg_pool_recip(avg_pool_recip_t *recip, const int32_t cnt)
+{
+    recip->cnt = cnt;
+    recip->half = cnt / 2;
+    if (cnt <= 0 || cnt > AVG_POOL_RECIP_MAX_CNT) {
+        recip->mult = 0;
+        return;
+    }
+    const uint64_t n_max = (uint64_t) cnt * 128 + cnt / 2;
+    int32_t shift = 0;
+    while (((uint64_t) 1 << shift) <= n_max * cnt) {
+        shift++;
+    }
+    recip->mult = (uint32_t) ((((uint64_t) 1 << shift) + cnt - 1) / cnt);
+    recip->shift = shift;
+    recip->narrow = n_max * recip->mult <= UINT32_MAX;
+}
+
+/**
+ * Rounded average exactly as `esp_nn_avg_pool_s8_ansi` computes it
+ */
+__NN_FORCE_INLINE__ int32_t esp_nn_avg_pool_round_div(const int32_t sum,
+                                                      const avg_pool_recip_t *recip)
+{
+    if (recip->mult == 0) {
+        return sum > 0 ? (sum + recip->half) / recip->cnt
+                       : (sum - recip->half) / recip->cnt;
+    }
+    const uint32_t n = sum > 0 ? sum + recip->half : recip->half - sum;
+    uint32_t quot;
+    if (recip->narrow) {
+        quot = (n * recip->mult) >> recip->shift;
+    } else {
+        quot = (uint32_t) (((uint64_t) n * recip->mult) >> recip->shift);
+    }
+    return sum > 0 ? (int32_t) quot : -(int32_t) quot;
+}
+
+__NN_FORCE_INLINE__ void esp_nn_avg_pool_store(int8_t *out, const int32_t *acc,
+                                               const int32_t n_ch,
+                                               const avg_pool_recip_t *recip,
+                                               const int32_t activation_min,
+                                               const int32_t activation_max)
+{
+    for (int32_t ch = 0; ch < n_ch; ch++) {
+        int32_t result = esp_nn_avg_pool_round_div(acc[ch], recip);
+        result = max(result, activation_min);
+        result = min(result, activation_max);
+        out[ch] = (int8_t) result;
+    }
+}
+
+/**
+ * Sum of `rows` pixels `step` apart, for n_ch channels: acc += sum, or
+ * acc -= sum when `subtract`. Four channels at a time in registers.
+ */
+__NN_FORCE_INLINE__ void esp_nn_avg_pool_sum_col(int32_t *acc, const int8_t *col,
+                                                 const int32_t rows, const int32_t step,
+                                                 const int32_t n_ch, const bool subtract)
+{
+    int32_t ch = 0;
+    for (; ch < n_ch - 3; ch += 4) {
+        const int8_t *in_ptr = col + ch;
+        int32_t sum0 = 0, sum1 = 0, sum2 = 0, sum3 = 0;
+        for (int32_t r = 0; r < rows; r++, in_ptr += step) {
+            sum0 += in_ptr[0];
+            sum1 += in_ptr[1];
+            sum2 += in_ptr[2];
+            sum3 += in_ptr[3];
+        }
+        if (subtract) {
+            acc[ch + 0] -= sum0;
+            acc[ch + 1] -= sum1;
+            acc[ch + 2] -= sum2;
+            acc[ch + 3] -= sum3;
+        } else {
+            acc[ch + 0] += sum0;
+            acc[ch + 1] += sum1;
+            acc[ch + 2] += sum2;
+            acc[ch + 3] += sum3;
+        }
+    }
+    for (; ch < n_ch; ch++) {
+        const int8_t *in_ptr = col + ch;
+        int32_t sum = 0;
+        for (int32_t r = 0; r < rows; r++, in_ptr += step) {
+            sum += *in_ptr;
+        }
+        acc[ch] += subtract ? -sum : sum;
+    }
+}
+
+/**
+ * Single output averaging the whole input: one linear pass over it.
+ */
+static void esp_nn_avg_pool_s8_global(const int8_t *input,
+                                      const uint16_t input_wd,
+                                      const uint16_t input_ht,
+                                      int8_t *output,
+                                      const int32_t activation_min,
+                                      const int32_t activation_max,
+                                      const uint16_t channels)
+{
+    const int32_t pixels = input_wd * input_ht;
+    avg_pool_recip_t recip;
+    esp_nn_avg_pool_recip(&recip, pixels);
+
+    for (int32_t ch0 = 0; ch0 < channels; ch0 += AVG_POOL_CH_BLOCK) {
+        const int32_t n_ch = min(AVG_POOL_CH_BLOCK, channels - ch0);
+        int32_t acc[AVG_POOL_CH_BLOCK] = {0};
+        esp_nn_avg_pool_sum_col(acc, input + ch0, pixels, channels, n_ch, false);
+        esp_nn_avg_pool_store(output + ch0, acc, n_ch, &recip, activation_min, activation_max);
+    }
+}
+
+void esp_nn_avg_pool_s8_opt(const int8_t *input,
+                            const uint16_t input_wd,
+                            const uint16_t input_ht,
+                            int8_t *output,
+                            const uint16_t output_wd,
+                            const uint16_t output_ht,
+                            const uint16_t stride_wd,
+                            const uint16_t stride_ht,
+                            const uint16_t filter_wd,
+                            const uint16_t filter_ht,
+                            const uint16_t pad_wd,
+                            const uint16_t pad_ht,
+                            const int32_t activation_min,
+                            const int32_t activation_max,
+                            const uint16_t channels)
+{
+    if (output_wd == 1 && output_ht == 1 &&
+            filter_wd - pad_wd >= input_wd && filter_ht - pad_ht >= input_ht) {
+        esp_nn_avg_pool_s8_global(input, input_wd, input_ht, output,
+                                  activation_min, activation_max, channels);
+        return;
+    }
+
+    const int32_t row_step = input_wd * channels;
+
+    /* full windows, and the last clipped window size seen at the borders */
+    avg_pool_recip_t recip_full, recip_edge;
+    esp_nn_avg_pool_recip(&recip_full, filter_wd * filter_ht);
+    recip_edge.cnt = -1;
+
+    /**
+     * Column sums over the window rows slide along each output row: moving to
+     * the next output only adds the columns entering the window and subtracts
+     * those leaving it. The window edges clip to the input the same way as the
+     * reference kernel, so sums and counts match it.
+     */
+    for (int32_t ch0 = 0; ch0 < channels; ch0 += AVG_POOL_CH_BLOCK) {
+        const int32_t n_ch = min(AVG_POOL_CH_BLOCK, channels - ch0);
+        int32_t acc[AVG_POOL_CH_BLOCK];
+
+        int32_t base_y = -pad_ht;
+        for (int32_t out_y = 0; out_y < output_ht; out_y++, base_y += stride_ht) {
+            const int32_t y_start = max(0, base_y);
+            const int32_t rows = min(base_y + filter_ht, (int32_t) input_ht) - y_start;
+            const int8_t *in_rows = input + y_start * row_step + ch0;
+            int8_t *out_ptr = output + out_y * output_wd * channels + ch0;
+
+            /* the input columns [win_start, win_end) summed in acc */
+            int32_t win_start = 0, win_end = 0;
+            int32_t base_x = -pad_wd;
+            for (int32_t out_x = 0; out_x < output_wd; out_x++, base_x += stride_wd) {
+                const int32_t x_start = max(0, base_x);
+                const int32_t x_end = min(base_x + filter_wd, (int32_t) input_wd);
+
+                if (out_x == 0 || x_start >= win_end) {
+                    for (int32_t ch = 0; ch < n_ch; ch++) {
+                        acc[ch] = 0;
+                    }
+                    win_start = win_end = x_start;
+                }
+                for (; win_end < x_end; win_end++) {
+                    esp_nn_avg_pool_sum_col(acc, in_rows + win_end * channels, rows, row_step, n_ch, false);
+                }
+                for (; win_start < x_start; win_start++) {
+                    esp_nn_avg_pool_sum_col(acc, in_rows + win_start * channels, rows, row_step, n_ch, true);
+                }
+
+                const int32_t filter_cnt = (x_end - x_start) * rows;
+                const avg_pool_recip_t *recip = &recip_full;
+                if (filter_cnt != recip_full.cnt) {
+                    if (filter_cnt != recip_edge.cnt) {
+                        esp_nn_avg_pool_recip(&recip_edge, filter_cnt);
+                    }
+                    recip = &recip_edge;
+                }
+                esp_nn_avg_pool_store(out_ptr, acc, n_ch, recip, activation_min, activation_max);
+                out_ptr += channels;
+            }
+        }
+    }
+}
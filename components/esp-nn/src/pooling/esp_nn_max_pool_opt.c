@@ -0,0 +1,298 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <stdint.h>
+
+#include <esp_nn_ansi_headers.h>
+#include <common_functions.h>
+
+/* words (4 channels each) in the on-stack row buffers */
+#define MAX_POOL_BUF_WORDS  64
+
+/* four int8 of -128 */
+#define MAX_POOL_S8X4_MIN   0x80808080u
+
+/**
+ * @brief   per byte mask: 0xff where signed a >= b, 0 otherwise
+ */
+__NN_FORCE_INLINE__ uint32_t esp_nn_ge_s8x4(const uint32_t a, const uint32_t b)
+{
+    /* high bit of each byte: low 7 bits of a >= those of b, no borrow across bytes */
+    const uint32_t low_ge = (a | 0x80808080u) - (b & 0x7f7f7f7fu);
+    /* a non-negative and b negative, or same sign and low_ge */
+    const uint32_t ge = ((b & ~a) | (~(a ^ b) & low_ge)) & 0x80808080u;
+    return (ge << 1) - (ge >> 7);
+}
+
+__NN_FORCE_INLINE__ uint32_t esp_nn_max_s8x4(const uint32_t a, const uint32_t b)
+{
+    const uint32_t mask = esp_nn_ge_s8x4(a, b);
+    return (a & mask) | (b & ~mask);
+}
+
+__NN_FORCE_INLINE__ uint32_t esp_nn_min_s8x4(const uint32_t a, const uint32_t b)
+{
+    const uint32_t mask = esp_nn_ge_s8x4(a, b);
+    return (b & mask) | (a & ~mask);
+}
+
+typedef struct {
+    bool clamp;         /* activation range narrower than int8 */
+    uint32_t min;
+    uint32_t max;
+} max_pool_act_t;
+
+static void esp_nn_max_pool_act_init(max_pool_act_t *act,
+                                     const int32_t activation_min,
+                                     const int32_t activation_max)
+{
+    const int32_t act_min = max(activation_min, INT8_MIN);
+    const int32_t act_max = min(activation_max, INT8_MAX);
+    act->clamp = act_min > INT8_MIN || act_max < INT8_MAX;
+    act->min = (uint8_t) act_min * 0x01010101u;
+    act->max = (uint8_t) act_max * 0x01010101u;
+}
+
+__NN_FORCE_INLINE__ void esp_nn_max_pool_store(int8_t *out, uint32_t val,
+                                               const max_pool_act_t *act)
+{
+    if (act->clamp) {
+        val = esp_nn_min_s8x4(esp_nn_max_s8x4(val, act->min), act->max);
+    }
+    esp_nn_store_s8x4(out, val);
+}
+
+/**
+ * 2x2 windows, stride 2, all inside the input: four loads per output word.
+ */
+static void esp_nn_max_pool_s8_2x2_s2(const int8_t *input,
+                                      const uint16_t input_wd,
+                                      int8_t *output,
+                                      const uint16_t output_wd,
+                                      const uint16_t output_ht,
+                                      const max_pool_act_t *act,
+                                      const uint16_t channels)
+{
+    const int32_t row_step = input_wd * channels;
+
+    for (int32_t out_y = 0; out_y < output_ht; out_y++) {
+        const int8_t *row0 = input + 2 * out_y * row_step;
+        const int8_t *row1 = row0 + row_step;
+        for (int32_t out_x = 0; out_x < output_wd; out_x++) {
+            for (int32_t ch = 0; ch < channels; ch += 4) {
+                const uint32_t top = esp_nn_max_s8x4(esp_nn_load_s8x4(row0 + ch),
+                                                     esp_nn_load_s8x4(row0 + channels + ch));
+                const uint32_t bottom = esp_nn_max_s8x4(esp_nn_load_s8x4(row1 + ch),
+                                                        esp_nn_load_s8x4(row1 + channels + ch));
+                esp_nn_max_pool_store(output + ch, esp_nn_max_s8x4(top, bottom), act);
+            }
+            row0 += 2 * channels;
+            row1 += 2 * channels;
+            output += channels;
+        }
+    }
+}
+
+/**
+ * max of input columns x, x + 1 and x + 2 of one row, for the word at `ch`
+ */
+__NN_FORCE_INLINE__ uint32_t esp_nn_max_pool_row3(const int8_t *ptr, const int32_t channels)
+{
+    return esp_nn_max_s8x4(esp_nn_max_s8x4(esp_nn_load_s8x4(ptr),
+                                           esp_nn_load_s8x4(ptr + channels)),
+                           esp_nn_load_s8x4(ptr + 2 * channels));
+}
+
+/**
+ * 3x3 windows, stride 2, all inside the input. The last window row of one
+ * output row is the first of the next, so its horizontal maxima are kept for
+ * a strip of outputs instead of being recomputed.
+ */
+static void esp_nn_max_pool_s8_3x3_s2(const int8_t *input,
+                                      const uint16_t input_wd,
+                                      int8_t *output,
+                                      const uint16_t output_wd,
+                                      const uint16_t output_ht,
+                                      const max_pool_act_t *act,
+                                      const uint16_t channels)
+{
+    const int32_t row_step = input_wd * channels;
+    const int32_t blk_ch = min((int32_t) channels, MAX_POOL_BUF_WORDS * 4);
+    const int32_t strip_wd = MAX_POOL_BUF_WORDS * 4 / blk_ch;
+    uint32_t shared_row[MAX_POOL_BUF_WORDS];
+
+    for (int32_t strip_x = 0; strip_x < output_wd; strip_x += strip_wd) {
+        const int32_t n_out = min(strip_wd, output_wd - strip_x);
+        for (int32_t ch0 = 0; ch0 < channels; ch0 += blk_ch) {
+            const int32_t n_ch = min(blk_ch, channels - ch0);
+            const int8_t *in_col = input + 2 * strip_x * channels + ch0;
+
+            /* first window row of the first output row */
+            uint32_t *buf = shared_row;
+            for (int32_t i = 0; i < n_out; i++) {
+                for (int32_t ch = 0; ch < n_ch; ch += 4) {
+                    *buf++ = esp_nn_max_pool_row3(in_col + 2 * i * channels + ch, channels);
+                }
+            }
+
+            for (int32_t out_y = 0; out_y < output_ht; out_y++) {
+                const int8_t *row1 = in_col + (2 * out_y + 1) * row_step;
+                const int8_t *row2 = row1 + row_step;
+                int8_t *out_ptr = output + (out_y * output_wd + strip_x) * channels + ch0;
+                buf = shared_row;
+                for (int32_t i = 0; i < n_out; i++) {
+                    for (int32_t ch = 0; ch < n_ch; ch += 4) {
+                        const int32_t offset = 2 * i * channels + ch;
+                        const uint32_t mid = esp_nn_max_pool_row3(row1 + offset, channels);
+                        const uint32_t last = esp_nn_max_pool_row3(row2 + offset, channels);
+                        esp_nn_max_pool_store(out_ptr + ch,
+                                              esp_nn_max_s8x4(esp_nn_max_s8x4(*buf, mid), last), act);
+                        *buf++ = last;
+                    }
+                    out_ptr += channels;
+                }
+            }
+        }
+    }
+}
+
+/**
+ * Any window, stride and padding. For each output row, a vertical pass takes
+ * the max over the window rows of every input column a strip of outputs
+ * needs, into a row buffer; a horizontal pass then reduces the buffer to the
+ * outputs. Overlapping windows share the column maxima. Windows clip to the
+ * input like the reference kernel; an empty one yields -128.
+ */
+static void esp_nn_max_pool_s8_separable(const int8_t *input,
+                                         const uint16_t input_wd,
+                                         const uint16_t input_ht,
+                                         int8_t *output,
+                                         const uint16_t output_wd,
+                                         const uint16_t output_ht,
+                                         const uint16_t stride_wd,
+                                         const uint16_t stride_ht,
+                                         const uint16_t filter_wd,
+                                         const uint16_t filter_ht,
+                                         const uint16_t pad_wd,
+                                         const uint16_t pad_ht,
+                                         const max_pool_act_t *act,
+                                         const uint16_t channels)
+{
+    const int32_t row_step = input_wd * channels;
+    /* channels per block such that one window row fits the buffer */
+    const int32_t blk_ch = min((int32_t) channels, MAX_POOL_BUF_WORDS / filter_wd * 4);
+    const int32_t strip_wd = (MAX_POOL_BUF_WORDS * 4 / blk_ch - filter_wd) / stride_wd + 1;
+    uint32_t col_max[MAX_POOL_BUF_WORDS];
+
+    int32_t base_y = -pad_ht;
+    for (int32_t out_y = 0; out_y < output_ht; out_y++, base_y += stride_ht) {
+        const int32_t y_start = max(0, base_y);
+        const int32_t y_end = min(base_y + filter_ht, (int32_t) input_ht);
+
+        for (int32_t strip_x = 0; strip_x < output_wd; strip_x += strip_wd) {
+            const int32_t n_out = min(strip_wd, output_wd - strip_x);
+            const int32_t strip_base_x = strip_x * stride_wd - pad_wd;
+            const int32_t col_start = max(0, strip_base_x);
+            const int32_t col_end = min(strip_base_x + (n_out - 1) * stride_wd + filter_wd,
+                                        (int32_t) input_wd);
+
+            for (int32_t ch0 = 0; ch0 < channels; ch0 += blk_ch) {
+                const int32_t n_words = min(blk_ch, channels - ch0) / 4;
+
+                /* vertical pass */
+                uint32_t *buf = col_max;
+                for (int32_t in_x = col_start; in_x < col_end; in_x++) {
+                    const int8_t *in_col = input + y_start * row_step + in_x * channels + ch0;
+                    for (int32_t word = 0; word < n_words; word++) {
+                        const int8_t *in_ptr = in_col + 4 * word;
+                        uint32_t result = MAX_POOL_S8X4_MIN;
+                        for (int32_t in_y = y_start; in_y < y_end; in_y++, in_ptr += row_step) {
+                            result = esp_nn_max_s8x4(result, esp_nn_load_s8x4(in_ptr));
+                        }
+                        *buf++ = result;
+                    }
+                }
+
+                /* horizontal pass */
+                int8_t *out_ptr = output + (out_y * output_wd + strip_x) * channels + ch0;
+                int32_t base_x = strip_base_x;
+                for (int32_t i = 0; i < n_out; i++, base_x += stride_wd, out_ptr += channels) {
+                    const int32_t x_start = max(0, base_x);
+                    const int32_t x_end = min(base_x + filter_wd, (int32_t) input_wd);
+                    for (int32_t word = 0; word < n_words; word++) {
+                        const uint32_t *col = col_max + (x_start - col_start) * n_words + word;
+                        uint32_t result = MAX_POOL_S8X4_MIN;
+                        for (int32_t in_x = x_start; in_x < x_end; in_x++, col += n_words) {
+                            result = esp_nn_max_s8x4(result, *col);
+                        }
+                        esp_nn_max_pool_store(out_ptr + 4 * word, result, act);
+                    }
+                }
+            }
+        }
+    }
+}
+
+void esp_nn_max_pool_s8_opt(const int8_t *input,
+                            const uint16_t input_wd,
+                            const uint16_t input_ht,
+                            int8_t *output,
+                            const uint16_t output_wd,
+                            const uint16_t output_ht,
+                            const uint16_t stride_wd,
+                            const uint16_t stride_ht,
+                            const uint16_t filter_wd,
+                            const uint16_t filter_ht,
+                            const uint16_t pad_wd,
+                            const uint16_t pad_ht,
+                            const int32_t activation_min,
+                            const int32_t activation_max,
+                            const uint16_t channels)
+{
+    /**
+     * the word-wise kernels need whole, aligned words of channels, and a
+     * window row of at least one word must fit the row buffer
+     */
+    if ((channels & 3) || (((uintptr_t) input | (uintptr_t) output) & 3) ||
+            filter_wd > MAX_POOL_BUF_WORDS) {
+        esp_nn_max_pool_s8_ansi(input, input_wd, input_ht, output, output_wd, output_ht,
+                                stride_wd, stride_ht, filter_wd, filter_ht, pad_wd, pad_ht,
+                                activation_min, activation_max, channels);
+        return;
+    }
+
+    max_pool_act_t act;
+    esp_nn_max_pool_act_init(&act, activation_min, activation_max);
+
+    /* windows that never leave the input */
+    const bool inside = pad_wd == 0 && pad_ht == 0 &&
+                        (output_wd - 1) * stride_wd + filter_wd <= input_wd &&
+                        (output_ht - 1) * stride_ht + filter_ht <= input_ht;
+
+    if (inside && stride_wd == 2 && stride_ht == 2) {
+        if (filter_wd == 2 && filter_ht == 2) {
+            esp_nn_max_pool_s8_2x2_s2(input, input_wd, output, output_wd, output_ht,
+                                      &act, channels);
+            return;
+        }
+        if (filter_wd == 3 && filter_ht == 3) {
+            esp_nn_max_pool_s8_3x3_s2(input, input_wd, output, output_wd, output_ht,
+                                      &act, channels);
+            return;
+        }
+    }
+    esp_nn_max_pool_s8_separable(input, input_wd, input_ht, output, output_wd, output_ht,
+                                 stride_wd, stride_ht, filter_wd, filter_ht, pad_wd, pad_ht,
+                                 &act, channels);
+}
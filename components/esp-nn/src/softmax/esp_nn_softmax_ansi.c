@@ -27,6 +27,16 @@ void esp_nn_set_softmax_scratch_buf_ansi(void *buffer)
     return;
 }
 
+void esp_nn_prepare_softmax_s8_ansi(const int32_t mult,
+                                    const int32_t shift,
+                                    const int32_t diff_min)
+{
+    (void) mult;
+    (void) shift;
+    (void) diff_min;
+    return;
+}
+
 void esp_nn_softmax_s8_ansi(const int8_t *input_data,
                             const int32_t height,
                             const int32_t width,
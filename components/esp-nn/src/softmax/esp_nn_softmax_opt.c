@@ -13,9 +13,21 @@
 // limitations under the License.
 
 #include "softmax_common.h"
-#include <stdio.h>
+#include <stdbool.h>
 
-static int32_t *scratch_buf = NULL;
+/* exp table indexed by `max_in_row - input`, the only 256 values input_diff takes */
+#define SOFTMAX_LUT_SIZE    256
+
+/**
+ * The table lives here rather than in the caller's scratch: scratch may be
+ * handed to other kernels between softmax calls (arena allocators reuse the
+ * same pointer), so nothing could be trusted to survive in it.
+ */
+static int32_t exp_lut[SOFTMAX_LUT_SIZE];
+
+/* parameters exp_lut was built for */
+static bool lut_valid = false;
+static int32_t lut_mult, lut_shift, lut_diff_min;
 
 /**
  * @brief   Get scratch buffer size needed by softmax function
@@ -24,23 +36,52 @@ static int32_t *scratch_buf = NULL;
  * @param   height
  * @return  size in bytes
  *
- * @note    buffer must be 4 byte aligned
+ * @note    the exp table is kernel owned, no scratch is needed
  */
 int32_t esp_nn_get_softmax_scratch_size_opt(const int32_t width, const int32_t height)
 {
+    (void) width;
     (void) height;
-    return width * 4;
+    return 0;
 }
 
 /**
  * @brief   Set scratch buffer to be used by softmax function
  *
- * @param   buffer  this can be NULL if one needs to unset it
- *                  must be aligned to 4 bytes
+ * @param   buffer  unused, kept for API compatibility
  */
 void esp_nn_set_softmax_scratch_buf_opt(void *buffer)
 {
-    scratch_buf = (int32_t *) buffer;
+    (void) buffer;
+    return;
+}
+
+void esp_nn_prepare_softmax_s8_opt(const int32_t mult,
+                                   const int32_t shift,
+                                   const int32_t diff_min)
+{
+    if (lut_valid && lut_mult == mult && lut_shift == shift && lut_diff_min == diff_min) {
+        return;
+    }
+    const int32_t mask = (1 << shift);
+
+    /**
+     * Differences below diff_min get 0: they then add nothing to the sum and
+     * come out as -128, exactly as the reference kernel skipping them does.
+     */
+    for (int32_t idx = 0; idx < SOFTMAX_LUT_SIZE; idx++) {
+        const int32_t input_diff = -idx;
+        int32_t exp_raw = 0;
+        if (input_diff >= diff_min) {
+            const int32_t input_diff_rescaled = SAT_HIGH_MUL(input_diff * mask, mult);
+            exp_raw = esp_nn_exp_on_negative_values(input_diff_rescaled);
+        }
+        exp_lut[idx] = exp_raw;
+    }
+    lut_mult = mult;
+    lut_shift = shift;
+    lut_diff_min = diff_min;
+    lut_valid = true;
 }
 
 void esp_nn_softmax_s8_opt(const int8_t *input_data,
@@ -51,10 +92,8 @@ void esp_nn_softmax_s8_opt(const int8_t *input_data,
                            const int32_t diff_min,
                            int8_t *output_data)
 {
-    if (scratch_buf == NULL) {
-        printf("%s error! scratch buffer not set\n", __FUNCTION__);
-        return;
-    }
+    /* no-op when the table already matches */
+    esp_nn_prepare_softmax_s8_opt(mult, shift, diff_min);
     // The representation chosen for the input to the exp() function is Q5.26.
     // We need to leave extra space since values that we skip might be as large as
     // -32 before multiplying by input mult, and therefore as large as
@@ -63,7 +102,6 @@ void esp_nn_softmax_s8_opt(const int8_t *input_data,
 #define ACCUM_BITS  12
 #define DIFF_BITS   5
 
-    const int32_t mask = (1 << shift);
     int32_t col = 0;
     const int8_t *in_ptr = input_data;
     int8_t *out_ptr = output_data;
@@ -74,17 +112,9 @@ void esp_nn_softmax_s8_opt(const int8_t *input_data,
             max_in_row = max(max_in_row, in_ptr[col]);
         }
 
-        int32_t input_diff = 0;
         int32_t sum_of_exps = 0;
-
         for (col = 0; col < width; col++) {
-            input_diff = in_ptr[col] - max_in_row;
-            if (input_diff >= diff_min) {
-                const int32_t input_diff_rescaled = SAT_HIGH_MUL(input_diff * mask, mult);
-                const int32_t exp_raw = esp_nn_exp_on_negative_values(input_diff_rescaled);
-                scratch_buf[col] = exp_raw; // store to avoid duplicate calculation later
-                sum_of_exps += DIV_POW2(exp_raw, ACCUM_BITS);
-            }
+            sum_of_exps += DIV_POW2(exp_lut[max_in_row - in_ptr[col]], ACCUM_BITS);
         }
 
         const int32_t headroom_plus1 = esp_nn_clz32((uint32_t) sum_of_exps);
@@ -92,9 +122,8 @@ void esp_nn_softmax_s8_opt(const int8_t *input_data,
         const int32_t bits_over_unit = ACCUM_BITS - headroom_plus1 + 31 - sizeof(int8_t) * 8;
 
         for (col = 0; col < width; col++) {
-            input_diff = in_ptr[col] - max_in_row;
-            if (input_diff >= diff_min) {
-                int32_t exp_raw = scratch_buf[col];
+            const int32_t exp_raw = exp_lut[max_in_row - in_ptr[col]];
+            if (exp_raw != 0) {
                 const int32_t shifted_output = SAT_HIGH_MUL(shifted_scale, exp_raw);
                 const int32_t result = DIV_POW2(shifted_output, bits_over_unit) - 128;
                 out_ptr[col] = (int8_t) esp_nn_saturate8(result);
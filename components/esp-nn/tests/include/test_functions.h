@@ -25,6 +25,7 @@ void esp_nn_max_pool_s8_test();
 
 void esp_nn_fully_connected_s8_test();
 void esp_nn_fully_connected_per_ch_s8_test();
+void esp_nn_fully_connected_batch_s8_test();
 
 void esp_nn_relu6_s8_test();
 
@@ -74,7 +74,7 @@ void esp_nn_add_elementwise_s8_test()
     int32_t activation_min = -128;
     int32_t activation_max = 127;
 
-    for (int itr = 0; itr < 10; itr++) {
+    for (int itr = 0; itr < 11; itr++) {
         switch (itr) {
         case 0: // all zeros
             input1_offset = 0;
@@ -137,6 +137,19 @@ void esp_nn_add_elementwise_s8_test()
             left_shift = 20;
             size = 216;
         break;
+        case 10: // constant input2, as with a broadcast operand
+            input1_offset = 64;
+            input2_offset = 128;
+            output_offset = -128;
+            input1_mult = 1705397815;
+            input2_mult = 1073741824;
+            output_mult = 1756091225;
+            input1_shift = -3;
+            input2_shift = 0;
+            output_shift = -19;
+            left_shift = 20;
+            size = 1600 + 8 + 7;
+        break;
         default:  // practical random input
             input1_offset = rand() % 256 - 127; // range [-127, 128]
             input2_offset = rand() % 256 - 127; // range [-127, 128]
@@ -179,6 +192,9 @@ void esp_nn_add_elementwise_s8_test()
                 input2[i] = rand() % 256 - 128;
             }
         }
+        if (itr == 10) {
+            memset(input2, rand() % 256 - 128, size);
+        }
 
         if (itr == 0) {
             /* enable profiler */
@@ -260,7 +276,7 @@ void esp_nn_mul_elementwise_s8_test()
     int8_t *out_c_orig = NULL;
     int8_t *out_opt_orig = NULL;
 
-    for (int itr = 0; itr < 10; itr++) {
+    for (int itr = 0; itr < 11; itr++) {
         switch (itr) {
         case 0: // all zeros
             input1_offset = 0;
@@ -290,6 +306,14 @@ void esp_nn_mul_elementwise_s8_test()
             output_mult = MULT_MAX;
             output_shift = 0;
         break;
+        case 10: // constant input1, as with a broadcast operand
+            input1_offset = rand() % 256 - 127; // range [-127, 128]
+            input2_offset = rand() % 256 - 127; // range [-127, 128]
+            output_offset = rand() % 256 - 128; // range [-128, 127]
+            output_mult = MULT_MAX / 2 + rand() % INT16_MAX;
+            output_shift = -8 + rand() % 4;
+            size = 1600 + 8 + 7;
+        break;
         default:  // practical random input
             input1_offset = rand() % 256 - 127; // range [-127, 128]
             input2_offset = rand() % 256 - 127; // range [-127, 128]
@@ -323,6 +347,9 @@ void esp_nn_mul_elementwise_s8_test()
             input1[i] = rand() % 256 - 128;
             input2[i] = rand() % 256 - 128;
         }
+        if (itr == 10) {
+            memset(input1, rand() % 256 - 128, size);
+        }
 
         if (itr == 0) {
             /* enable profiler */
@@ -20,7 +20,7 @@ void esp_nn_depthwise_conv_s8_test()
     int8_t *input = NULL, *filter_data = NULL;
     int8_t *out_data_c = NULL, *out_data_opt = NULL;
     int32_t *bias = NULL;
-    int32_t input_offset = 5; /* some number in [-128, 127] */
+    int32_t input_offset;
     int32_t out_offset = 7;
     int32_t activation_min = -125;
     int32_t activation_max = 120;
@@ -30,10 +30,18 @@ void esp_nn_depthwise_conv_s8_test()
     int input_wd, input_ht, channels;
     uint16_t filter_ht, filter_wd, ch_mult, out_wd, out_ht;
     uint16_t pad_wd, pad_ht, stride_wd, stride_ht;
+    uint16_t dilation_wd, dilation_ht;
+    bool use_scratch;
 
     printf("\n######## Running %s ##########\n", __FUNCTION__);
-    // run for 15 iterations
-    for (int itr = 0; itr < 15; itr++) {
+    // run for 21 iterations
+    for (int itr = 0; itr < 21; itr++) {
+        /* 0 is the legacy "no dilation"; the dilation cases override it */
+        dilation_wd = 0;
+        dilation_ht = 0;
+        input_offset = 5; /* some number in [-128, 127] */
+        use_scratch = true;
+
         /* prepare data */
         switch (itr) {
         case 0: // (ch_mult 1, (channels % 16) = 0), filter (3,3), pad (0,0)
@@ -156,6 +164,84 @@ void esp_nn_depthwise_conv_s8_test()
             stride_wd = 2;
             stride_ht = 2;
             break;
+        case 10: // (ch_mult 1, (channels % 4) != 0), filter (5,5), pad (2,2)
+            input_wd = 11;
+            input_ht = 9;
+            filter_ht = 5;
+            filter_wd = 5;
+            ch_mult = 1;
+            channels = 10;
+            pad_wd = 2;
+            pad_ht = 2;
+            stride_wd = 1;
+            stride_ht = 1;
+            break;
+        case 11: // (ch_mult 1), filter (5,5), pad (2,2), stride (2,2)
+            input_wd = 13;
+            input_ht = 12;
+            filter_ht = 5;
+            filter_wd = 5;
+            ch_mult = 1;
+            channels = 8;
+            pad_wd = 2;
+            pad_ht = 2;
+            stride_wd = 2;
+            stride_ht = 2;
+            break;
+        case 12: // (ch_mult 1), filter (3,3), dilation (2,2), pad (2,2)
+            input_wd = 12;
+            input_ht = 10;
+            filter_ht = 3;
+            filter_wd = 3;
+            ch_mult = 1;
+            channels = 8;
+            pad_wd = 2;
+            pad_ht = 2;
+            stride_wd = 1;
+            stride_ht = 1;
+            dilation_wd = 2;
+            dilation_ht = 2;
+            break;
+        case 13: // (ch_mult 2), filter (3,3), dilation (2,3), pad (0,0)
+            input_wd = 11;
+            input_ht = 13;
+            filter_ht = 3;
+            filter_wd = 3;
+            ch_mult = 2;
+            channels = 5;
+            pad_wd = 0;
+            pad_ht = 0;
+            stride_wd = 1;
+            stride_ht = 1;
+            dilation_wd = 2;
+            dilation_ht = 3;
+            break;
+        case 19: // as case 10, generic kernel without a scratch buffer
+            input_wd = 11;
+            input_ht = 9;
+            filter_ht = 5;
+            filter_wd = 5;
+            ch_mult = 1;
+            channels = 10;
+            pad_wd = 2;
+            pad_ht = 2;
+            stride_wd = 1;
+            stride_ht = 1;
+            use_scratch = false;
+            break;
+        case 20: // (ch_mult 2), filter (3,3), pad (1,1), input_offset -128
+            input_wd = 9;
+            input_ht = 7;
+            filter_ht = 3;
+            filter_wd = 3;
+            ch_mult = 2;
+            channels = 6;
+            pad_wd = 1;
+            pad_ht = 1;
+            stride_wd = 1;
+            stride_ht = 1;
+            input_offset = -128;
+            break;
         default:
             input_wd = 6;
             input_ht = 6;
@@ -174,12 +260,12 @@ void esp_nn_depthwise_conv_s8_test()
         if (pad_wd) {
             out_wd = (input_wd + stride_wd - 1) / stride_wd;
         } else {
-            out_wd = (input_wd + stride_wd - filter_wd) / stride_wd;
+            out_wd = (input_wd + stride_wd - ((filter_wd - 1) * max(dilation_wd, 1) + 1)) / stride_wd;
         }
         if (pad_ht) {
             out_ht = (input_ht + stride_ht - 1) / stride_ht;
         } else {
-            out_ht = (input_ht + stride_ht - filter_ht) / stride_ht;
+            out_ht = (input_ht + stride_ht - ((filter_ht - 1) * max(dilation_ht, 1) + 1)) / stride_ht;
         }
 
         // if (itr == 9) {
@@ -232,12 +318,15 @@ void esp_nn_depthwise_conv_s8_test()
         data_dims_t filter_dims = {.width = filter_wd, .height = filter_ht, 0, 0};
         dw_conv_params_t conv_params = {.in_offset = input_offset, .out_offset = out_offset, .ch_mult = ch_mult,
                                         .stride = {stride_wd, stride_ht}, .padding = {pad_wd, pad_ht},
-                                        .dilation = {0, 0}, .activation = {activation_min, activation_max}};
+                                        .dilation = {dilation_wd, dilation_ht}, .activation = {activation_min, activation_max}};
         quant_data_t quant_data = {.shift = out_shift, .mult = out_mult};
 
         int scratch_buf_size = esp_nn_get_depthwise_conv_scratch_size(&input_dims, &filter_dims,
                                                                       &output_dims, &conv_params);
-        if (scratch_buf_size > 0) {
+        if (!use_scratch) {
+            /* only the generic kernel runs without one */
+            esp_nn_set_depthwise_conv_scratch_buf_opt(NULL);
+        } else if (scratch_buf_size > 0) {
             scratch_buf = ESP_NN_TEST_ALLOC(scratch_buf_size + 16);
             if (scratch_buf == NULL) {
                 printf(ANSI_COLOR_RED"[%d] scratch_buf alloc failed size %d\n"ANSI_COLOR_RESET,
@@ -259,8 +348,13 @@ void esp_nn_depthwise_conv_s8_test()
         profile_opt_start();
 
         /* Optimized function */
-        esp_nn_depthwise_conv_s8(&input_dims, input, &filter_dims, filter_data + 4,
-                                 bias + 1, &output_dims, out_data_opt, &conv_params, &quant_data);
+        if (use_scratch) {
+            esp_nn_depthwise_conv_s8(&input_dims, input, &filter_dims, filter_data + 4,
+                                     bias + 1, &output_dims, out_data_opt, &conv_params, &quant_data);
+        } else {
+            esp_nn_depthwise_conv_s8_opt(&input_dims, input, &filter_dims, filter_data + 4,
+                                         bias + 1, &output_dims, out_data_opt, &conv_params, &quant_data);
+        }
 
         /* disable profiler */
         total_opt = profile_opt_end();
@@ -309,14 +403,16 @@ void esp_nn_depthwise_conv_s8_test()
         }
         if (scratch_buf) {
             free(scratch_buf);
+            scratch_buf = NULL;
         }
+        esp_nn_set_depthwise_conv_scratch_buf(NULL);
     }
 }
 
 void esp_nn_conv_s8_test()
 {
     uint32_t total_c = 0, total_opt = 0;
-    const int32_t input_offset = 5; /* some number in [-128, 127] */
+    int32_t input_offset;
     const int32_t activation_min = -125;
     const int32_t activation_max = 122;
     const int32_t out_offset = 3;
@@ -332,10 +428,18 @@ void esp_nn_conv_s8_test()
     int in_wd, in_ht, in_channels, out_channels;
     uint16_t filter_ht, filter_wd, out_wd, out_ht;
     uint16_t pad_wd, pad_ht, stride_wd, stride_ht;
+    uint16_t dilation_wd, dilation_ht;
+    bool use_scratch;
 
     printf("\n######## Running %s ##########\n", __FUNCTION__);
-    // run for 10 iterations
-    for (int itr = 0; itr < 15; itr++) {
+    // run for 19 iterations
+    for (int itr = 0; itr < 19; itr++) {
+        /* 0 is the legacy "no dilation"; the dilation cases override it */
+        dilation_wd = 0;
+        dilation_ht = 0;
+        input_offset = 5; /* some number in [-128, 127] */
+        use_scratch = true;
+
         switch (itr) {
         case 0: // ch % 8 == 0 && filter (1,1), padding (0,0)
             in_wd = 10;
@@ -481,6 +585,72 @@ void esp_nn_conv_s8_test()
             stride_wd = 2;
             stride_ht = 2;
             break;
+        case 12: // filter (1,1), odd out_channels and pixel count (tile remainders)
+            in_wd = 5;
+            in_ht = 3;
+            in_channels = 7;
+            out_channels = 11;
+            filter_ht = 1;
+            filter_wd = 1;
+            pad_wd = 0;
+            pad_ht = 0;
+            stride_wd = 1;
+            stride_ht = 1;
+            break;
+        case 13: // filter (3,3), dilation (2,2), pad (2,2)
+            in_wd = 9;
+            in_ht = 9;
+            in_channels = 5;
+            out_channels = 6;
+            filter_ht = 3;
+            filter_wd = 3;
+            pad_wd = 2;
+            pad_ht = 2;
+            stride_wd = 1;
+            stride_ht = 1;
+            dilation_wd = 2;
+            dilation_ht = 2;
+            break;
+        case 14: // filter (3,3), dilation (3,2), pad (0,0), stride (2,2)
+            in_wd = 12;
+            in_ht = 10;
+            in_channels = 4;
+            out_channels = 8;
+            filter_ht = 3;
+            filter_wd = 3;
+            pad_wd = 0;
+            pad_ht = 0;
+            stride_wd = 2;
+            stride_ht = 2;
+            dilation_wd = 3;
+            dilation_ht = 2;
+            break;
+        case 15: // filter (3,3), pad (1,1), generic kernel without a scratch buffer
+            in_wd = 7;
+            in_ht = 6;
+            in_channels = 5;
+            out_channels = 6;
+            filter_ht = 3;
+            filter_wd = 3;
+            pad_wd = 1;
+            pad_ht = 1;
+            stride_wd = 1;
+            stride_ht = 1;
+            use_scratch = false;
+            break;
+        case 16: // filter (3,3), pad (1,1), input_offset -128 (direct path)
+            in_wd = 7;
+            in_ht = 6;
+            in_channels = 5;
+            out_channels = 6;
+            filter_ht = 3;
+            filter_wd = 3;
+            pad_wd = 1;
+            pad_ht = 1;
+            stride_wd = 1;
+            stride_ht = 1;
+            input_offset = -128;
+            break;
         default: // ch % 8 == 0
             in_wd = 8;
             in_ht = 8;
@@ -499,12 +669,12 @@ void esp_nn_conv_s8_test()
         if (pad_wd) {
             out_wd = (in_wd + stride_wd - 1) / stride_wd;
         } else {
-            out_wd = (in_wd + stride_wd - filter_wd) / stride_wd;
+            out_wd = (in_wd + stride_wd - ((filter_wd - 1) * max(dilation_wd, 1) + 1)) / stride_wd;
         }
         if (pad_ht) {
             out_ht = (in_ht + stride_ht - 1) / stride_ht;
         } else {
-            out_ht = (in_ht + stride_ht - filter_ht) / stride_ht;
+            out_ht = (in_ht + stride_ht - ((filter_ht - 1) * max(dilation_ht, 1) + 1)) / stride_ht;
         }
 
         int in_size = in_wd * in_ht * in_channels;
@@ -561,17 +731,16 @@ void esp_nn_conv_s8_test()
         data_dims_t filter_dims = {.width = filter_wd, .height = filter_ht, 0, 0};
         conv_params_t conv_params = {.in_offset = input_offset, .out_offset = out_offset,
                                     .stride = {stride_wd, stride_ht}, .padding = {pad_wd, pad_ht},
-                                    .dilation = {0, 0}, .activation = {activation_min, activation_max}};
+                                    .dilation = {dilation_wd, dilation_ht}, .activation = {activation_min, activation_max}};
         quant_data_t quant_data = {.shift = out_shift, .mult = out_mult};
 
         int scratch_buf_size = esp_nn_get_conv_scratch_size(&input_dims, &filter_dims,
                                                             &output_dims, &conv_params);
-        if (scratch_buf_size > 0) {
-#if IDF_HEAP_CAPS
-            void *scratch_buf = heap_caps_malloc(scratch_buf_size + 16, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
-#else
-            void *scratch_buf = malloc(scratch_buf_size + 16);
-#endif
+        if (!use_scratch) {
+            /* only the generic kernel runs without one */
+            esp_nn_set_conv_scratch_buf_opt(NULL);
+        } else if (scratch_buf_size > 0) {
+            scratch_buf = ESP_NN_TEST_ALLOC(scratch_buf_size + 16);
             if (scratch_buf == NULL) {
                 printf(ANSI_COLOR_RED"scratch_buf alloc failed size %d\n"ANSI_COLOR_RESET, scratch_buf_size);
                 goto conv_s8_cleanup;
@@ -591,8 +760,13 @@ void esp_nn_conv_s8_test()
         profile_opt_start();
 
         /* Optimized function */
-        esp_nn_conv_s8(&input_dims, input, &filter_dims, filter_data,
-                       bias, &output_dims, out_data_opt, &conv_params, &quant_data);
+        if (use_scratch) {
+            esp_nn_conv_s8(&input_dims, input, &filter_dims, filter_data,
+                           bias, &output_dims, out_data_opt, &conv_params, &quant_data);
+        } else {
+            esp_nn_conv_s8_opt(&input_dims, input, &filter_dims, filter_data,
+                               bias, &output_dims, out_data_opt, &conv_params, &quant_data);
+        }
 
         /* disable profiler */
         total_opt = profile_opt_end();
@@ -647,6 +821,8 @@ void esp_nn_conv_s8_test()
         }
         if (scratch_buf) {
             free(scratch_buf);
+            scratch_buf = NULL;
         }
+        esp_nn_set_conv_scratch_buf(NULL);
     }
 }
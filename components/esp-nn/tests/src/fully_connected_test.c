@@ -19,10 +19,13 @@ void esp_nn_fully_connected_s8_test()
     uint32_t total_c = 0, total_opt = 0;
     /* prepare data */
     uint16_t row_len = 256 + 8 + 7; /* odd len to test unaligned+left-over */
+    const int32_t max_out_ch = 16;
     uint16_t out_channels = 3;
     int8_t input[row_len];
-    int8_t filter_data[row_len * out_channels];
-    int8_t output_c[out_channels], output_opt[out_channels];
+    int8_t filter_data[row_len * max_out_ch];
+    int8_t output_c[max_out_ch], output_opt[max_out_ch];
+    int32_t bias[max_out_ch];
+    int32_t *bias_ptr = NULL;
     int32_t activation_min = -128;
     int32_t activation_max = 127;
     int32_t input_offset = 0;
@@ -87,13 +90,22 @@ void esp_nn_fully_connected_s8_test()
         for (int i = 0; i < row_len * out_channels; ++i) {
             filter_data[i] = rand() % 256 - 128;
         }
+        /* later iterations exercise offsets and bias */
+        if (itr >= 10) {
+            input_offset = rand() % 256 - 127;
+            filter_offset = (itr & 1) ? rand() % 256 - 127 : 0;
+            for (int i = 0; i < out_channels; ++i) {
+                bias[i] = rand() % INT16_MAX - INT16_MAX / 2;
+            }
+            bias_ptr = bias;
+        }
 
         /* enable profiler */
         profile_c_start();
 
         /* C function */
         esp_nn_fully_connected_s8_ansi(input, input_offset, row_len, filter_data, filter_offset,
-                                    NULL, output_c, out_channels, out_offset, out_shift, out_mult,
+                                    bias_ptr, output_c, out_channels, out_offset, out_shift, out_mult,
                                     activation_min, activation_max);
 
         total_c = profile_c_end();
@@ -101,7 +113,7 @@ void esp_nn_fully_connected_s8_test()
 
         /* Optimized function */
         esp_nn_fully_connected_s8(input, input_offset, row_len, filter_data, filter_offset,
-                                NULL, output_opt, out_channels, out_offset, out_shift, out_mult,
+                                bias_ptr, output_opt, out_channels, out_offset, out_shift, out_mult,
                                 activation_min, activation_max);
 
         /* disable profiler */
@@ -274,3 +286,93 @@ void esp_nn_fully_connected_per_ch_s8_test()
         }
     }
 }
+
+void esp_nn_fully_connected_batch_s8_test()
+{
+    uint32_t total_c = 0, total_opt = 0, total_rows = 0;
+    const uint16_t row_len = 256 + 8 + 7;
+    const int32_t max_batches = 33;
+    const int32_t max_out_ch = 16;
+    const uint16_t batch_sizes[] = {1, 4, 16, 5, 33};
+    const uint16_t out_ch_sizes[] = {16, 16, 16, 7, 13};
+    int32_t activation_min = -128;
+    int32_t activation_max = 127;
+    int32_t out_offset = 3;
+    int32_t bias[max_out_ch];
+
+    int8_t *input = ESP_NN_TEST_ALLOC(row_len * max_batches);
+    int8_t *filter_data = ESP_NN_TEST_ALLOC(row_len * max_out_ch);
+    int8_t *output_c = ESP_NN_TEST_ALLOC(max_batches * max_out_ch);
+    int8_t *output_opt = ESP_NN_TEST_ALLOC(max_batches * max_out_ch);
+
+    printf("\n######## Running %s ##########\n", __FUNCTION__);
+    if (input == NULL || filter_data == NULL || output_c == NULL || output_opt == NULL) {
+        printf(ANSI_COLOR_RED"%s allocations failed\n"ANSI_COLOR_RESET, __FUNCTION__);
+        goto fully_connected_batch_cleanup;
+    }
+
+    for (int itr = 0; itr < sizeof(batch_sizes) / sizeof(batch_sizes[0]); itr++) {
+        uint16_t batches = batch_sizes[itr];
+        uint16_t out_channels = out_ch_sizes[itr];
+        int32_t input_offset = rand() % 256 - 127;
+        int32_t filter_offset = (itr == 3) ? rand() % 256 - 127 : 0;
+        int32_t out_shift = -10 + rand() % 5;
+        int32_t out_mult = INT32_MAX / row_len + rand() % INT16_MAX;
+
+        for (int i = 0; i < row_len * batches; ++i) {
+            input[i] = rand() % 256 - 128;
+        }
+        for (int i = 0; i < row_len * out_channels; ++i) {
+            filter_data[i] = rand() % 256 - 128;
+        }
+        for (int i = 0; i < out_channels; ++i) {
+            bias[i] = rand() % INT16_MAX - INT16_MAX / 2;
+        }
+
+        profile_c_start();
+        esp_nn_fully_connected_batch_s8_ansi(input, input_offset, row_len, batches, filter_data,
+                                             filter_offset, bias, output_c, out_channels, out_offset,
+                                             out_shift, out_mult, activation_min, activation_max);
+        total_c = profile_c_end();
+
+        /* one row at a time, batching must not be slower */
+        profile_opt_start();
+        for (int b = 0; b < batches; b++) {
+            esp_nn_fully_connected_s8(input + b * row_len, input_offset, row_len, filter_data,
+                                      filter_offset, bias, output_opt + b * out_channels,
+                                      out_channels, out_offset, out_shift, out_mult,
+                                      activation_min, activation_max);
+        }
+        total_rows = profile_opt_end();
+
+        profile_opt_start();
+        esp_nn_fully_connected_batch_s8(input, input_offset, row_len, batches, filter_data,
+                                        filter_offset, bias, output_opt, out_channels, out_offset,
+                                        out_shift, out_mult, activation_min, activation_max);
+        total_opt = profile_opt_end();
+
+        bool ret = CHECK_EQUAL(output_c, output_opt, batches * out_channels);
+        if (ret == false) {
+            printf(ANSI_COLOR_RED"[%3d] failed\n"ANSI_COLOR_RESET, itr);
+            goto fully_connected_batch_cleanup;
+        }
+        printf(ANSI_COLOR_GREEN"[%3d] passed [batch %"PRIu16", row_len %"PRIu16", out_ch %"PRIu16"]"ANSI_COLOR_RESET,
+               itr, batches, row_len, out_channels);
+        printf("\tcycles: c %8"PRIu32", opt rows %8"PRIu32", opt batch %8"PRIu32"\n",
+               total_c, total_rows, total_opt);
+    }
+
+fully_connected_batch_cleanup:
+    if (input) {
+        free(input);
+    }
+    if (filter_data) {
+        free(filter_data);
+    }
+    if (output_c) {
+        free(output_c);
+    }
+    if (output_opt) {
+        free(output_opt);
+    }
+}
@@ -0,0 +1,299 @@
+/*
+ * SPDX-FileCopyrightText: 2020-2023 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <malloc.h>
+
+#include <esp_nn.h>
+#include "test_utils.h"
+
+
+void esp_nn_avg_pool_s8_test()
+{
+    /* prepare data */
+    uint16_t input_wd, input_ht, channels;
+    uint16_t pad_wd, pad_ht, stride_wd, stride_ht, filter_wd, filter_ht;
+    int32_t activation_min, activation_max;
+    const int max_size = 6 * 1024; /* largest input across iterations */
+    int8_t *input = NULL, *output_c = NULL, *output_opt = NULL;
+
+    int8_t *input_orig = malloc(max_size + 16);
+    int8_t *out_c_orig = malloc(max_size + 16);
+    int8_t *out_opt_orig = malloc(max_size + 16);
+    if (input_orig == NULL || out_c_orig == NULL || out_opt_orig == NULL) {
+        printf(ANSI_COLOR_RED"%s allocations failed\n"ANSI_COLOR_RESET, __FUNCTION__);
+        goto avg_pool_s8_cleanup;
+    }
+
+    input = (int8_t *) (((uint32_t) input_orig + 15) & ~15);
+    output_c = (int8_t *) (((uint32_t) out_c_orig + 15) & ~15);
+    output_opt = (int8_t *) (((uint32_t) out_opt_orig + 15) & ~15);
+
+    /**
+     * width/height, channels etc look suspicious but it it true.
+     * It actually depends upon where in model this is actually placed.
+     * If at the end wd/ht tends to be smaller and depth larger.
+     */
+
+    for (int itr = 0; itr < 5; itr++) {
+        activation_min = -128;
+        activation_max = 127;
+
+        switch (itr) {
+        case 0: // filter (3,3), pad (1,1), overlapping windows
+            input_wd = 16;
+            input_ht = 16;
+            channels = 16; /* With TFLite example, I have seen it 256 */
+            filter_wd = 3;
+            filter_ht = 3;
+            pad_wd = 1;
+            pad_ht = 1;
+            stride_wd = 1;
+            stride_ht = 1;
+            break;
+        case 1: // filter (2,2), stride (2,2), disjoint windows
+            input_wd = 16;
+            input_ht = 16;
+            channels = 16;
+            filter_wd = 2;
+            filter_ht = 2;
+            pad_wd = 0;
+            pad_ht = 0;
+            stride_wd = 2;
+            stride_ht = 2;
+            break;
+        case 2: // filter (5,5), pad (2,2), more channels than one block
+            input_wd = 13;
+            input_ht = 11;
+            channels = 36;
+            filter_wd = 5;
+            filter_ht = 5;
+            pad_wd = 2;
+            pad_ht = 2;
+            stride_wd = 2;
+            stride_ht = 2;
+            break;
+        case 3: // global average pool
+            input_wd = 7;
+            input_ht = 7;
+            channels = 48;
+            filter_wd = 7;
+            filter_ht = 7;
+            pad_wd = 0;
+            pad_ht = 0;
+            stride_wd = 1;
+            stride_ht = 1;
+            break;
+        default: // filter (3,3), stride (2,2), narrower activation range
+            input_wd = 15;
+            input_ht = 15;
+            channels = 8;
+            filter_wd = 3;
+            filter_ht = 3;
+            pad_wd = 0;
+            pad_ht = 0;
+            stride_wd = 2;
+            stride_ht = 2;
+            activation_min = -20;
+            activation_max = 30;
+            break;
+        }
+
+        const int size = input_wd * input_ht * channels;
+        const uint16_t out_wd = (input_wd + 2 * pad_wd - filter_wd) / stride_wd + 1;
+        const uint16_t out_ht = (input_ht + 2 * pad_ht - filter_ht) / stride_ht + 1;
+        const int out_size = out_wd * out_ht * channels;
+
+        for (int i = 0; i < size; ++i) {
+            input[i] = rand() % 256 - 128;
+        }
+
+        /* enable profiler */
+        profile_c_start();
+
+        /* C function */
+        esp_nn_avg_pool_s8_ansi(input, input_wd, input_ht, output_c, out_wd, out_ht,
+                                stride_wd, stride_ht, filter_wd, filter_ht, pad_wd, pad_ht,
+                                activation_min, activation_max, channels);
+
+        profile_c_end();
+        profile_opt_start();
+
+        /* Optimized function */
+        esp_nn_avg_pool_s8(input, input_wd, input_ht, output_opt, out_wd, out_ht,
+                           stride_wd, stride_ht, filter_wd, filter_ht, pad_wd, pad_ht,
+                           activation_min, activation_max, channels);
+
+        /* disable profiler */
+        profile_opt_end();
+
+        bool ret = CHECK_EQUAL(output_c, output_opt, out_size);
+        if (ret == false) {
+            printf(ANSI_COLOR_RED"%s[%d] failed\n"ANSI_COLOR_RESET, __FUNCTION__, itr);
+            printf("Output: \n");
+            PRINT_ARRAY_HEX(output_opt, out_wd * channels, out_ht);
+            printf("Expected: \n");
+            PRINT_ARRAY_HEX(output_c, out_wd * channels, out_ht);
+            printf("Input:\n");
+            PRINT_ARRAY_HEX(input, input_wd * channels, input_ht);
+            goto avg_pool_s8_cleanup;
+        }
+        printf(ANSI_COLOR_GREEN"%s[%d] passed\n"ANSI_COLOR_RESET, __FUNCTION__, itr);
+    }
+
+avg_pool_s8_cleanup:
+    if (input_orig) {
+        free(input_orig);
+    }
+    if (out_c_orig) {
+        free(out_c_orig);
+    }
+    if (out_opt_orig) {
+        free(out_opt_orig);
+    }
+}
+
+void esp_nn_max_pool_s8_test()
+{
+    /* prepare data */
+    uint16_t input_wd, input_ht, channels;
+    uint16_t pad_wd, pad_ht, stride_wd, stride_ht, filter_wd, filter_ht;
+    int32_t activation_min, activation_max;
+    const int max_size = 6 * 1024; /* largest input across iterations */
+    int8_t *input = NULL, *output_c = NULL, *output_opt = NULL;
+
+    int8_t *input_orig = malloc(max_size + 16);
+    int8_t *out_c_orig = malloc(max_size + 16);
+    int8_t *out_opt_orig = malloc(max_size + 16);
+    if (input_orig == NULL || out_c_orig == NULL || out_opt_orig == NULL) {
+        printf(ANSI_COLOR_RED"%s allocations failed\n"ANSI_COLOR_RESET, __FUNCTION__);
+        goto max_pool_s8_cleanup;
+    }
+
+    input = (int8_t *) (((uint32_t) input_orig + 15) & ~15);
+    output_c = (int8_t *) (((uint32_t) out_c_orig + 15) & ~15);
+    output_opt = (int8_t *) (((uint32_t) out_opt_orig + 15) & ~15);
+
+    for (int itr = 0; itr < 5; itr++) {
+        activation_min = -128;
+        activation_max = 127;
+
+        switch (itr) {
+        case 0: // filter (3,3), pad (1,1), the README case
+            input_wd = 16;
+            input_ht = 16;
+            channels = 16; /* With TFLite example, I have seen it 256 */
+            filter_wd = 3;
+            filter_ht = 3;
+            pad_wd = 1;
+            pad_ht = 1;
+            stride_wd = 1;
+            stride_ht = 1;
+            break;
+        case 1: // filter (2,2), stride (2,2)
+            input_wd = 16;
+            input_ht = 16;
+            channels = 16;
+            filter_wd = 2;
+            filter_ht = 2;
+            pad_wd = 0;
+            pad_ht = 0;
+            stride_wd = 2;
+            stride_ht = 2;
+            break;
+        case 2: // filter (3,3), stride (2,2)
+            input_wd = 17;
+            input_ht = 13;
+            channels = 24;
+            filter_wd = 3;
+            filter_ht = 3;
+            pad_wd = 0;
+            pad_ht = 0;
+            stride_wd = 2;
+            stride_ht = 2;
+            break;
+        case 3: // filter (3,3), stride (2,2), pad (1,1)
+            input_wd = 14;
+            input_ht = 10;
+            channels = 40;
+            filter_wd = 3;
+            filter_ht = 3;
+            pad_wd = 1;
+            pad_ht = 1;
+            stride_wd = 2;
+            stride_ht = 2;
+            break;
+        default: // filter (5,3), narrower activation range
+            input_wd = 12;
+            input_ht = 9;
+            channels = 8;
+            filter_wd = 5;
+            filter_ht = 3;
+            pad_wd = 2;
+            pad_ht = 1;
+            stride_wd = 1;
+            stride_ht = 1;
+            activation_min = -20;
+            activation_max = 30;
+            break;
+        }
+
+        const int size = input_wd * input_ht * channels;
+        const uint16_t out_wd = (input_wd + 2 * pad_wd - filter_wd) / stride_wd + 1;
+        const uint16_t out_ht = (input_ht + 2 * pad_ht - filter_ht) / stride_ht + 1;
+        const int out_size = out_wd * out_ht * channels;
+
+        for (int i = 0; i < size; ++i) {
+            input[i] = rand() % 256 - 128;
+        }
+
+        /* enable profiler */
+        profile_c_start();
+
+        /* C function */
+        esp_nn_max_pool_s8_ansi(input, input_wd, input_ht, output_c, out_wd, out_ht,
+                                stride_wd, stride_ht, filter_wd, filter_ht, pad_wd, pad_ht,
+                                activation_min, activation_max, channels);
+
+        profile_c_end();
+        profile_opt_start();
+
+        /* Optimized function */
+        esp_nn_max_pool_s8(input, input_wd, input_ht, output_opt, out_wd, out_ht,
+                           stride_wd, stride_ht, filter_wd, filter_ht, pad_wd, pad_ht,
+                           activation_min, activation_max, channels);
+
+        /* disable profiler */
+        profile_opt_end();
+
+        bool ret = CHECK_EQUAL(output_c, output_opt, out_size);
+        if (ret == false) {
+            printf(ANSI_COLOR_RED"%s[%d] failed\n"ANSI_COLOR_RESET, __FUNCTION__, itr);
+            printf("Output: \n");
+            PRINT_ARRAY_HEX(output_opt, out_wd * out_ht * channels, 1);
+            printf("Expected: \n");
+            PRINT_ARRAY_HEX(output_c, out_wd * out_ht * channels, 1);
+            printf("Input:\n");
+            PRINT_ARRAY_HEX(input, 8, size / 8);
+            goto max_pool_s8_cleanup;
+        }
+        printf(ANSI_COLOR_GREEN"%s[%d] passed\n"ANSI_COLOR_RESET, __FUNCTION__, itr);
+    }
+
+max_pool_s8_cleanup:
+    if (input_orig) {
+        free(input_orig);
+    }
+    if (out_c_orig) {
+        free(out_c_orig);
+    }
+    if (out_opt_orig) {
+        free(out_opt_orig);
+    }
+}
@@ -1,10 +1,14 @@
 #include "adc.h"
 #include "driver/adc.h"
 #include "nvs.h"
+#include "goertzel.h"
+#include "zcross.h"
+#include "sched.h"
 #include "esp_console.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "esp_log.h"
+#include "esp_timer.h"
 
 
 static const char *TAG = "ADC";
@@ -23,20 +27,114 @@ int adc_raw[CH_MAX] = {0};
 int adc_avg[CH_MAX] = {0};
 int adc_filtered[CH_MAX] = {0};
 int hysteresis[CH_MAX] = {10,10,10,10,10,10};
+uint32_t adc_freq_mhz[CH_MAX] = {0};
+uint32_t adc_period_us[CH_MAX] = {0};
+uint16_t adc_duty_permille[CH_MAX] = {0};
+
+/* Acquisition buffer: per-channel ring of raw samples, shared write index */
+static int16_t adc_buf[CH_MAX][ADC_BUF_LEN];
+static volatile uint32_t adc_buf_count = 0;
+
+static volatile adc_wake_hook_t wake_hook = NULL;
 
 bool check_channel(int ch) { return (ch >= 0 && ch < CH_MAX); }
 
+/**
+ * @brief Publish a zero-crossing result for a channel
+ */
+static void publish_zcross(int ch, const zc_result_t *zc)
+{
+    adc_freq_mhz[ch] = zcross_freq_mhz(zc->period_q8, ADC_SAMPLE_RATE_MHZ);
+    adc_period_us[ch] = (uint32_t)(((uint64_t)zc->period_q8 * 1000000000ULL / ADC_SAMPLE_RATE_MHZ) >> 8);
+    adc_duty_permille[ch] = zc->period_q8 ? (uint16_t)(((uint64_t)zc->high_q8 * 1000) / zc->period_q8) : 0;
+}
+
+/**
+ * @brief Running average, hysteresis and min/max scaling for one sample
+ */
+void adc_filter_sample(int *avg, int *filtered, int raw, bool smoothed,
+                       int hyst, int32_t min_val, int32_t max_val)
+{
+    /* A burst mean is already smoothed, use it directly */
+    if(smoothed)
+        *avg = raw;
+    else
+        *avg = *avg - *avg/AVG_SMOOTH + raw/AVG_SMOOTH;
+
+    if(*avg > *filtered + hyst)
+        *filtered = *avg;
+    else if(*avg < *filtered - hyst)
+        *filtered = *avg;
+
+    if (max_val > min_val) {
+        *filtered = min_val + ((*filtered * (max_val - min_val)) / 4095);
+    } else {
+        *filtered = min_val;
+    }
+}
+
+/**
+ * @brief Read one processed sample for a channel
+ *
+ * Continuous mode reads a single conversion and feeds the AC analysis
+ * stages, whose timebase is ADC_PERIOD_MS. Low-power mode reads a burst
+ * back-to-back and returns its mean (oversampling), skipping AC analysis
+ * whatever the burst length: its samples are not ADC_PERIOD_MS apart.
+ */
+static int adc_acquire(int ch, bool low_power, int burst, zc_result_t *zc)
+{
+    if(low_power) {
+        int32_t sum = 0;
+        for(int i=0; i<burst; i++) {
+            sum += adc1_get_raw(adc_channels[ch]);
+        }
+        return sum / burst;
+    }
+
+    int raw = adc1_get_raw(adc_channels[ch]);
+    goertzel_update(ch, (int16_t)raw);
+    if(zcross_update(ch, (int16_t)raw, zc)) {
+        publish_zcross(ch, zc);
+    }
+    return raw;
+}
+
+/**
+ * @brief Sleep until the next scheduled wake, like vTaskDelayUntil
+ *
+ * A schedule change notifies the task: the wait ends early and the new
+ * period counts from now, so leaving a long low-power interval takes effect
+ * at once.
+ *
+ * @return false if the wait was cut short by a schedule change
+ */
+static bool adc_wait_next_wake(TickType_t *last_wake)
+{
+    TickType_t period = pdMS_TO_TICKS(sched_wake_period_ms());
+    TickType_t elapsed = xTaskGetTickCount() - *last_wake;
+
+    if(elapsed < period && ulTaskNotifyTake(pdTRUE, period - elapsed)) {
+        *last_wake = xTaskGetTickCount();
+        return false;
+    }
+    /* Overrun or timeout: keep the fixed cadence */
+    *last_wake += period;
+    return true;
+}
+
 /**
  * @brief ADC FreeRTOS task.
  *
- * Reads raw ADC values, calculates running average, applies hysteresis,
- * and saves new filtered values to NVS if changed.
+ * Wakes on the schedule computed by the sampling scheduler, reads raw ADC
+ * values into the acquisition buffer, calculates running average, applies
+ * hysteresis, and caches new filtered values for the config task to persist.
  *
  * @param arg Task argument (unused)
  */
 void adc_task(void *arg)
 {
     static int last_saved[CH_MAX] = {0};
+    zc_result_t zc;
 
     /* Configure ADC attenuation once */
     for(int ch=0; ch<CH_MAX; ch++) {
@@ -47,35 +145,49 @@ void adc_task(void *arg)
 
     ESP_LOGI(TAG, "ADC task started, monitoring %d channels", CH_MAX);
 
+    sched_set_wake_task(xTaskGetCurrentTaskHandle());
+
+    TickType_t last_wake = xTaskGetTickCount();
+    int64_t prev_wake_us = esp_timer_get_time();
+    bool scheduled = true;
+
     while(1) {
+        int64_t wake_us = esp_timer_get_time();
+        bool low_power = sched_get_mode() == SCHED_MODE_LOW_POWER;
+        int burst = sched_burst_len();
+
         for(int ch=0; ch<CH_MAX; ch++) {
-            adc_raw[ch] = adc1_get_raw(adc_channels[ch]);
-            adc_avg[ch] = adc_avg[ch] - adc_avg[ch]/AVG_SMOOTH + adc_raw[ch]/AVG_SMOOTH;
-
-            if(adc_avg[ch] > adc_filtered[ch] + hysteresis[ch])
-                adc_filtered[ch] = adc_avg[ch];
-            else if(adc_avg[ch] < adc_filtered[ch] - hysteresis[ch])
-                adc_filtered[ch] = adc_avg[ch];
-
-            // Apply min/max scaling from NVS configuration
-            int32_t min_val = nvs_get_channel_i32("ch_min", ch, 0);
-            int32_t max_val = nvs_get_channel_i32("ch_max", ch, 4095);
-
-            if (max_val > min_val) {
-                adc_filtered[ch] = min_val + ((adc_filtered[ch] * (max_val - min_val)) / 4095);
-            } else {
-                adc_filtered[ch] = min_val;
-            }
+            adc_raw[ch] = adc_acquire(ch, low_power, burst, &zc);
+            adc_buf[ch][adc_buf_count % ADC_BUF_LEN] = (int16_t)adc_raw[ch];
+
+            // Filter and scale with the cached NVS configuration
+            adc_filter_sample(&adc_avg[ch], &adc_filtered[ch], adc_raw[ch], low_power,
+                              hysteresis[ch], nvs_param_get(NVS_PARAM_MIN, ch),
+                              nvs_param_get(NVS_PARAM_MAX, ch));
 
             if(adc_filtered[ch] != last_saved[ch]) {
                 last_saved[ch] = adc_filtered[ch];
-                nvs_set_channel_i32("ch_val", ch, adc_filtered[ch]);
+                nvs_param_set(NVS_PARAM_VAL, ch, adc_filtered[ch]);
             }
         }
-        vTaskDelay(pdMS_TO_TICKS(200));
+        adc_buf_count++;
+
+        adc_wake_hook_t hook = wake_hook;
+        if(hook) hook(wake_us);
+
+        int64_t done_us = esp_timer_get_time();
+        sched_record_wake((uint32_t)(done_us - wake_us), (uint32_t)(wake_us - prev_wake_us),
+                          scheduled);
+        prev_wake_us = wake_us;
+
+        scheduled = adc_wait_next_wake(&last_wake);
     }
 }
 
+void adc_set_wake_hook(adc_wake_hook_t hook) {
+    wake_hook = hook;
+}
+
 int adc_get(int ch) {
     if(!check_channel(ch)) return -1;
     return adc_filtered[ch];
@@ -84,4 +196,49 @@ int adc_get(int ch) {
 float adc_get_normalized(int ch) {
     if(!check_channel(ch)) return -1.0f;
     return (float)adc_filtered[ch]/4095.0f;
+}
+
+int adc_read_block(int ch, int16_t *dst, int n) {
+    if(!check_channel(ch) || n <= 0 || n >= ADC_BUF_LEN) return -1;
+    for(int attempt=0; attempt<ADC_READ_RETRIES; attempt++) {
+        uint32_t count = adc_buf_snapshot();
+        if(count < (uint32_t)n) return -1;
+        uint32_t start = count - n;
+        for(int i=0; i<n; i++) {
+            dst[i] = adc_buf[ch][(start + i) % ADC_BUF_LEN];
+        }
+        if(adc_window_intact(count, n)) return n;
+    }
+    return -1;
+}
+
+uint32_t adc_buf_snapshot(void) {
+    return adc_buf_count;
+}
+
+bool adc_window_intact(uint32_t count, int n) {
+    /* The wake in progress writes slot adc_buf_count before incrementing it */
+    return adc_buf_count - count < (uint32_t)(ADC_BUF_LEN - n);
+}
+
+int adc_peek_block(int ch, uint32_t count, int n, const int16_t **run1, int *len1, const int16_t **run2) {
+    if(!check_channel(ch) || n <= 0 || n >= ADC_BUF_LEN) return -1;
+    if(count < (uint32_t)n) return -1;
+    int start = (count - n) % ADC_BUF_LEN;
+    int tail = ADC_BUF_LEN - start;
+    *run1 = &adc_buf[ch][start];
+    *len1 = (n < tail) ? n : tail;
+    *run2 = &adc_buf[ch][0];
+    return n;
+}
+
+uint32_t adc_sample_cost_us(int rounds) {
+    if(rounds <= 0) return 0;
+    int64_t start = esp_timer_get_time();
+    for(int i=0; i<rounds; i++) {
+        for(int ch=0; ch<CH_MAX; ch++) {
+            adc1_get_raw(adc_channels[ch]);
+        }
+    }
+    return (uint32_t)((esp_timer_get_time() - start) / rounds);
 }
\ No newline at end of file
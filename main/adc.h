@@ -1,5 +1,6 @@
 #pragma once
 #include <stdbool.h>
+#include <stdint.h>
 
 /**
  * @brief Number of ADC channels
@@ -11,12 +12,40 @@
  */
 #define AVG_SMOOTH 10
 
+/**
+ * @brief Sampling period of adc_task in milliseconds
+ */
+#define ADC_PERIOD_MS 200
+
+/**
+ * @brief Sample rate in milli-hertz (integer for fixed-point frequency math)
+ */
+#define ADC_SAMPLE_RATE_MHZ (1000000 / ADC_PERIOD_MS)
+
+/**
+ * @brief Raw samples kept per channel in the acquisition buffer
+ *
+ * One entry per wake: a single conversion in continuous mode, the burst
+ * mean in low-power mode (see sched.h).
+ */
+#define ADC_BUF_LEN 1024
+
+/**
+ * @brief Copies adc_read_block() attempts before giving up on a torn read
+ */
+#define ADC_READ_RETRIES 4
+
 /* Global ADC arrays */
 extern int adc_raw[CH_MAX];
 extern int adc_avg[CH_MAX];
 extern int adc_filtered[CH_MAX];
 extern int hysteresis[CH_MAX];
 
+/* AC estimates from zero-crossing detection (0 when no signal) */
+extern uint32_t adc_freq_mhz[CH_MAX];
+extern uint32_t adc_period_us[CH_MAX];
+extern uint16_t adc_duty_permille[CH_MAX];
+
 /**
  * @brief Check if the channel index is valid
  * @param ch Channel index
@@ -24,6 +53,33 @@ extern int hysteresis[CH_MAX];
  */
 bool check_channel(int ch);
 
+/**
+ * @brief Level filter for one sample: running average, hysteresis, scaling
+ * @param avg Running average state, updated
+ * @param filtered Filtered output state, updated
+ * @param raw New sample
+ * @param smoothed true if raw is already a burst mean (skips the average)
+ * @param hyst Hysteresis in ADC counts
+ * @param min_val Scaling minimum
+ * @param max_val Scaling maximum
+ */
+void adc_filter_sample(int *avg, int *filtered, int raw, bool smoothed,
+                       int hyst, int32_t min_val, int32_t max_val);
+
+/**
+ * @brief Called by adc_task after each wake's samples are in the ring
+ * @param wake_us esp_timer time the wake started
+ */
+typedef void (*adc_wake_hook_t)(int64_t wake_us);
+
+/**
+ * @brief Install the wake hook (one at a time, NULL to remove)
+ *
+ * The hook runs in adc_task and delays the next wake by its run time, so
+ * it must only do bounded work and hand anything heavy to another task.
+ */
+void adc_set_wake_hook(adc_wake_hook_t hook);
+
 /**
  * @brief ADC task for FreeRTOS
  * @param arg Task argument (unused)
@@ -43,3 +99,60 @@ int adc_get(int ch);
  * @return Normalized value or -1.0 if invalid
  */
 float adc_get_normalized(int ch);
+
+/**
+ * @brief Copy the most recent raw samples of a channel, oldest first
+ *
+ * The copy is checked with adc_window_intact() and taken again if adc_task
+ * overwrote part of it meanwhile, up to ADC_READ_RETRIES times.
+ *
+ * @param ch Channel index
+ * @param dst Destination buffer of n samples
+ * @param n Number of samples (< ADC_BUF_LEN, the slot of the wake in
+ *          progress is never part of a window)
+ * @return n on success, -1 if invalid, not enough samples acquired yet or
+ *         every copy was torn
+ */
+int adc_read_block(int ch, int16_t *dst, int n);
+
+/**
+ * @brief Number of wakes written to the acquisition ring so far
+ *
+ * Take it once and pass it to adc_peek_block() for every channel of a
+ * window, so all channels end at the same wake.
+ */
+uint32_t adc_buf_snapshot(void);
+
+/**
+ * @brief Check that a window peeked at a snapshot has not been overwritten
+ * @param count Snapshot passed to adc_peek_block()
+ * @param n Window length
+ * @return true if no sample of the window has been replaced yet
+ */
+bool adc_window_intact(uint32_t count, int n);
+
+/**
+ * @brief Locate raw samples of a channel without copying
+ *
+ * The window ends at ring position count and may wrap the ring, so it is
+ * returned as two runs, oldest first; the second run holds n - *len1
+ * samples and may be empty. The runs are live ring memory, overwritten
+ * after ADC_BUF_LEN - n more wakes: outside adc_task, confirm with
+ * adc_window_intact() after reading.
+ *
+ * @param ch Channel index
+ * @param count Ring position from adc_buf_snapshot()
+ * @param n Number of samples (< ADC_BUF_LEN)
+ * @param run1 Set to the first (oldest) run
+ * @param len1 Set to the length of the first run
+ * @param run2 Set to the second run
+ * @return n on success, -1 if invalid or not enough samples acquired yet
+ */
+int adc_peek_block(int ch, uint32_t count, int n, const int16_t **run1, int *len1, const int16_t **run2);
+
+/**
+ * @brief Measure the cost of reading every channel once
+ * @param rounds Number of rounds to average over
+ * @return Microseconds per round
+ */
+uint32_t adc_sample_cost_us(int rounds);
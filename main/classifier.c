@@ -0,0 +1,226 @@
+#include "classifier.h"
+#include "quant.h"
+#include "pipeline.h"
+#include "nn_lock.h"
+#include <stdlib.h>
+#include <string.h>
+#include "esp_nn.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+static const char *TAG = "CLS";
+
+static const cls_model_t *model;
+static quant_adapter_t cls_quant;
+static TaskHandle_t cls_task_handle;
+
+/* Double-buffered input windows. adc_task fills the buffer that is not
+ * busy; the inference task takes the ready one. Both indices are -1 when
+ * unset and only change under cls_lock. */
+static int8_t cls_input[2][CLS_WINDOW * CLS_IN_CH];
+static int64_t cls_capture_us[2];
+static int cls_ready = -1;
+static int cls_busy = -1;
+static int cls_since_capture = 0;
+
+static int8_t conv_out[CLS_FC_IN];
+static int8_t logits[CLS_CLASSES];
+static int8_t probs[CLS_CLASSES];
+static void *conv_scratch;
+static void *softmax_scratch;
+
+static cls_result_t result;
+static cls_stats_t stats;
+static portMUX_TYPE cls_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static const data_dims_t in_dims = { .width = CLS_WINDOW, .height = 1, .channels = CLS_IN_CH, .extra = 1 };
+static const data_dims_t filter_dims = { .width = CLS_CONV_FILTER, .height = 1, .channels = CLS_IN_CH, .extra = 1 };
+static const data_dims_t conv_dims = { .width = CLS_CONV_OUT, .height = 1, .channels = CLS_CONV_CH, .extra = 1 };
+
+/**
+ * @brief Window capture, runs in adc_task after every wake
+ */
+static void classifier_on_wake(int64_t wake_us)
+{
+    if (++cls_since_capture < CLS_HOP) return;
+    cls_since_capture = 0;
+
+    /* Claim the idle buffer; a window still waiting in it is superseded */
+    portENTER_CRITICAL(&cls_lock);
+    int b = (cls_busy == 0) ? 1 : 0;
+    if (cls_ready == b) {
+        cls_ready = -1;
+        stats.dropped++;
+    }
+    portEXIT_CRITICAL(&cls_lock);
+
+    if (quant_fill(&cls_quant, cls_input[b], CLS_WINDOW) < 0) return;
+
+    portENTER_CRITICAL(&cls_lock);
+    if (cls_ready >= 0) stats.dropped++;
+    cls_ready = b;
+    cls_capture_us[b] = wake_us;
+    portEXIT_CRITICAL(&cls_lock);
+
+    xTaskNotifyGive(cls_task_handle);
+}
+
+/**
+ * @brief Run the network on one quantized window, result in probs
+ */
+static void classifier_run(const int8_t *input)
+{
+    conv_params_t conv_params = {
+        .in_offset = quant_input_offset(&cls_quant),
+        .out_offset = model->conv_out_offset,
+        .stride = { CLS_CONV_STRIDE, 1 },
+        .padding = { 0, 0 },
+        .dilation = { 1, 1 },
+        .activation = { -128, 127 },
+    };
+    quant_data_t conv_quant = {
+        .shift = (int32_t *)model->conv_shift,
+        .mult = (int32_t *)model->conv_mult,
+    };
+
+    /* Scratch pointers are global to esp-nn and the bench command changes
+     * them: hold the esp-nn lock from setting them until the last kernel */
+    nn_lock();
+    esp_nn_set_conv_scratch_buf(conv_scratch);
+    esp_nn_conv_s8(&in_dims, input, &filter_dims, model->conv_filter, model->conv_bias,
+                   &conv_dims, conv_out, &conv_params, &conv_quant);
+
+    esp_nn_fully_connected_s8(conv_out, -model->conv_out_offset, CLS_FC_IN,
+                              model->fc_filter, 0, model->fc_bias, logits, CLS_CLASSES,
+                              model->fc_out_offset, model->fc_shift, model->fc_mult, -128, 127);
+
+    esp_nn_set_softmax_scratch_buf(softmax_scratch);
+    esp_nn_softmax_s8(logits, 1, CLS_CLASSES, model->softmax_mult, model->softmax_shift,
+                      model->softmax_diff_min, probs);
+    nn_unlock();
+}
+
+/**
+ * @brief Inference task: waits for a captured window, infers, publishes
+ */
+static void classifier_task(void *arg)
+{
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        portENTER_CRITICAL(&cls_lock);
+        int b = cls_ready;
+        cls_ready = -1;
+        cls_busy = b;
+        portEXIT_CRITICAL(&cls_lock);
+        if (b < 0) continue;
+
+        int64_t start_us = esp_timer_get_time();
+        classifier_run(cls_input[b]);
+        int64_t done_us = esp_timer_get_time();
+
+        int top = 0;
+        for (int i = 1; i < CLS_CLASSES; i++) {
+            if (probs[i] > probs[top]) top = i;
+        }
+        uint32_t infer_us = (uint32_t)(done_us - start_us);
+        uint32_t latency_us = (uint32_t)(done_us - cls_capture_us[b]);
+
+        portENTER_CRITICAL(&cls_lock);
+        result.seq++;
+        memcpy(result.prob, probs, sizeof(probs));
+        result.top = top;
+        result.latency_us = latency_us;
+        stats.inferences++;
+        stats.infer_us_sum += infer_us;
+        if (infer_us > stats.infer_us_max) stats.infer_us_max = infer_us;
+        stats.latency_us_sum += latency_us;
+        if (latency_us > stats.latency_us_max) stats.latency_us_max = latency_us;
+        cls_busy = -1;
+        portEXIT_CRITICAL(&cls_lock);
+    }
+}
+
+/**
+ * @brief Allocate a 16-byte aligned esp-nn scratch buffer, NULL if not needed
+ */
+static esp_err_t alloc_scratch(int size, void **buf)
+{
+    *buf = NULL;
+    if (size <= 0) return ESP_OK;
+    void *raw = malloc(size + 16);
+    if (raw == NULL) return ESP_ERR_NO_MEM;
+    *buf = (void *)(((uintptr_t)raw + 15) & ~(uintptr_t)15);
+    return ESP_OK;
+}
+
+esp_err_t classifier_init(const cls_model_t *m)
+{
+    if (m == NULL) return ESP_ERR_INVALID_ARG;
+    model = m;
+
+    esp_err_t err = quant_init(&cls_quant, CLS_IN_CH, m->in_scale, m->in_zero_point);
+    if (err != ESP_OK) return err;
+
+    conv_params_t conv_params = { .stride = { CLS_CONV_STRIDE, 1 }, .dilation = { 1, 1 } };
+    err = alloc_scratch(esp_nn_get_conv_scratch_size(&in_dims, &filter_dims, &conv_dims, &conv_params),
+                        &conv_scratch);
+    if (err == ESP_OK) {
+        err = alloc_scratch(esp_nn_get_softmax_scratch_size(CLS_CLASSES, 1), &softmax_scratch);
+    }
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Scratch allocation failed");
+        return err;
+    }
+    /* Build the softmax exp table now rather than on the first inference */
+    nn_lock();
+    esp_nn_set_softmax_scratch_buf(softmax_scratch);
+    esp_nn_prepare_softmax_s8(m->softmax_mult, m->softmax_shift, m->softmax_diff_min);
+    nn_unlock();
+
+    classifier_reset_stats();
+    if (xTaskCreate(classifier_task, "cls_task", 4096, NULL, CLS_TASK_PRIORITY,
+                    &cls_task_handle) != pdPASS) {
+        return ESP_ERR_NO_MEM;
+    }
+    adc_set_wake_hook(classifier_on_wake);
+
+    ESP_LOGI(TAG, "Classifier started, window %d, hop %d", CLS_WINDOW, CLS_HOP);
+    return ESP_OK;
+}
+
+bool classifier_running(void)
+{
+    return cls_task_handle != NULL;
+}
+
+void classifier_get(cls_result_t *res)
+{
+    portENTER_CRITICAL(&cls_lock);
+    *res = result;
+    portEXIT_CRITICAL(&cls_lock);
+}
+
+void classifier_get_stats(cls_stats_t *out)
+{
+    portENTER_CRITICAL(&cls_lock);
+    *out = stats;
+    portEXIT_CRITICAL(&cls_lock);
+}
+
+void classifier_reset_stats(void)
+{
+    int64_t now = esp_timer_get_time();
+    portENTER_CRITICAL(&cls_lock);
+    memset(&stats, 0, sizeof(stats));
+    stats.since_us = now;
+    portEXIT_CRITICAL(&cls_lock);
+}
+
+const char *classifier_label(int cls)
+{
+    if (model == NULL || cls < 0 || cls >= CLS_CLASSES) return "?";
+    return model->labels[cls];
+}
@@ -0,0 +1,109 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "adc.h"
+
+/**
+ * @brief Input window (samples per channel) and hop between inferences (wakes)
+ */
+#define CLS_WINDOW 64
+#define CLS_HOP 16
+
+/**
+ * @brief Network shape: conv1d over all channels, fully connected, softmax
+ */
+#define CLS_IN_CH CH_MAX
+#define CLS_CONV_CH 8
+#define CLS_CONV_FILTER 5
+#define CLS_CONV_STRIDE 2
+#define CLS_CONV_OUT ((CLS_WINDOW - CLS_CONV_FILTER) / CLS_CONV_STRIDE + 1)
+#define CLS_FC_IN (CLS_CONV_OUT * CLS_CONV_CH)
+#define CLS_CLASSES 3
+
+/**
+ * @brief Quantized model (TFLite int8 conventions)
+ */
+typedef struct {
+    const char *labels[CLS_CLASSES];
+    float in_scale;                 /* input tensor scale */
+    int32_t in_zero_point;          /* input tensor zero point */
+    const int8_t *conv_filter;      /* [CLS_CONV_CH][1][CLS_CONV_FILTER][CLS_IN_CH] */
+    const int32_t *conv_bias;       /* [CLS_CONV_CH] */
+    const int32_t *conv_mult;       /* [CLS_CONV_CH] per-channel requant */
+    const int32_t *conv_shift;
+    int32_t conv_out_offset;
+    const int8_t *fc_filter;        /* [CLS_CLASSES][CLS_FC_IN] */
+    const int32_t *fc_bias;         /* [CLS_CLASSES] */
+    int32_t fc_mult;
+    int32_t fc_shift;
+    int32_t fc_out_offset;
+    int32_t softmax_mult;
+    int32_t softmax_shift;
+    int32_t softmax_diff_min;
+} cls_model_t;
+
+/**
+ * @brief Built-in model
+ */
+extern const cls_model_t cls_default_model;
+
+/**
+ * @brief Latest decision
+ */
+typedef struct {
+    uint32_t seq;                   /* inference number, 0 before the first */
+    int8_t prob[CLS_CLASSES];       /* softmax output, probability = (p + 128) / 256 */
+    int top;                        /* most likely class */
+    uint32_t latency_us;            /* newest sample acquired to decision published */
+} cls_result_t;
+
+/**
+ * @brief Inference statistics since the last reset
+ */
+typedef struct {
+    uint32_t inferences;
+    uint32_t dropped;               /* windows replaced before inference started */
+    uint32_t infer_us_sum;
+    uint32_t infer_us_max;
+    uint64_t latency_us_sum;
+    uint32_t latency_us_max;
+    int64_t since_us;               /* stats window start (esp_timer time) */
+} cls_stats_t;
+
+/**
+ * @brief Start the inference task and hook window capture into adc_task
+ *
+ * Every CLS_HOP wakes adc_task quantizes the latest window into whichever
+ * of two input buffers is not being inferred on, so sampling never waits
+ * for inference; an unconsumed window is replaced by the newer one.
+ *
+ * @param model Model to run
+ * @return ESP_OK, or an error if the model or memory is unavailable
+ */
+esp_err_t classifier_init(const cls_model_t *model);
+
+/**
+ * @brief Whether classifier_init() has started the inference task
+ */
+bool classifier_running(void);
+
+/**
+ * @brief Copy the latest decision
+ */
+void classifier_get(cls_result_t *res);
+
+/**
+ * @brief Copy the inference statistics
+ */
+void classifier_get_stats(cls_stats_t *stats);
+
+/**
+ * @brief Restart the inference statistics window
+ */
+void classifier_reset_stats(void);
+
+/**
+ * @brief Label of a class
+ */
+const char *classifier_label(int cls);
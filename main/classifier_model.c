@@ -0,0 +1,95 @@
+#include "classifier.h"
+
+/*
+ * Placeholder weights with the deployed model's shapes and quantization
+ * layout. Replace with the trained model export; only this file changes.
+ */
+
+static const int8_t conv_filter[CLS_CONV_CH * CLS_CONV_FILTER * CLS_IN_CH] = {
+    -4, -28, 5, 10, -1, 13, -3, -6, -6, 5, 12, -5, -2, -1, -13, 16, 25, 12, 29, -16,
+    31, -7, 15, 0, -3, -28, 12, 20, -3, -30, 11, -26, 24, 19, 26, 18, -1, -1, 14, 23,
+    -24, -7, -15, 14, 25, -16, -21, -24, -11, 21, -20, -23, 9, -15, 31, -26, 22, 2, 14, -1,
+    28, 25, 21, 29, -21, -12, 8, -22, -23, 28, -28, 19, -30, -2, -10, -1, 19, 10, 13, 12,
+    -12, 13, -31, 14, 9, 15, 0, 6, -25, -20, -4, -28, 7, -14, 22, -3, 12, 0, -23, 10,
+    20, 25, 22, -26, 0, 11, -13, 6, 4, 2, -14, -11, -19, -21, 19, 23, -11, 10, 10, 26,
+    8, 26, -18, -5, 20, -24, -26, -2, 19, -18, 19, -22, 24, -16, -3, 8, 27, 24, -1, 26,
+    4, 18, -14, 28, -8, -25, 27, -4, -25, 26, 20, 24, 18, 5, -5, -5, 29, -16, 28, 23,
+    24, -10, 31, 2, 13, 24, -15, -15, 9, 30, -13, -11, -21, -14, -27, -9, -18, -6, 17, -12,
+    -10, -8, -9, -7, 28, -28, -5, 30, -7, 5, 17, 2, -12, 17, -28, 10, 12, 10, 9, 24,
+    -28, 21, -25, 13, 18, 24, -30, -1, -27, 27, 12, -7, -6, 28, 11, -11, -2, -17, 8, 26,
+    0, 28, 28, -10, -2, -9, -5, -6, -21, -3, 30, -9, 3, -13, -14, 28, 15, -1, 2, -20,
+};
+
+static const int32_t conv_bias[CLS_CONV_CH] = {
+    -105, 35, -443, 354, -789, 221, -761, -155,
+};
+
+static const int32_t conv_mult[CLS_CONV_CH] = {
+    0x40000000, 0x40000000, 0x40000000, 0x40000000, 0x40000000, 0x40000000, 0x40000000, 0x40000000,
+};
+
+static const int32_t conv_shift[CLS_CONV_CH] = {
+    -6, -6, -6, -6, -6, -6, -6, -6,
+};
+
+static const int8_t fc_filter[CLS_CLASSES * CLS_FC_IN] = {
+    16, 31, -8, -23, 10, -17, 23, -22, 14, 31, -4, 9, 4, -22, 8, 5, -2, -13, -19, 24,
+    -4, 29, 29, -9, -5, -23, -12, 7, 2, 19, -28, 31, -22, -20, -28, 1, -16, -10, 24, 24,
+    -4, 1, -1, -15, -18, 8, 30, -7, -18, 10, -16, -5, -16, -22, 10, 22, 9, 6, 16, -1,
+    -11, 23, 26, -4, -28, 13, -29, 27, 9, -24, -9, -10, -32, 22, 27, -24, 1, 16, -7, 13,
+    -23, -14, 18, -5, 4, 30, -30, 2, -6, 17, 18, -28, -2, 0, -32, 20, 23, -6, 15, -16,
+    -20, -3, 14, -2, 18, 21, -23, -24, 22, -8, -15, -9, 9, -29, -20, 17, 14, -13, -3, -14,
+    -28, 2, 18, -20, -12, 7, 15, 31, 26, -20, -2, -10, -13, -18, -13, -26, -21, -9, 0, -25,
+    4, -5, 30, -15, -27, 20, 22, -11, -24, 30, -14, -32, -31, 18, -25, 17, -17, -29, -1, 20,
+    5, 26, 8, -26, -10, -14, -1, -24, 2, -13, -7, 31, -30, 15, 23, -15, 21, -2, -25, 31,
+    -23, 25, 26, 3, 8, -8, -22, 9, 8, 13, 8, -19, -16, -3, 6, -8, 11, 2, 9, -6,
+    -17, 1, -20, 6, 10, -20, -11, -16, -15, 23, -8, 7, -23, 27, 13, 19, -15, -19, -13, 13,
+    21, -4, 1, -31, -12, 12, 16, -28, 12, 21, -22, 21, 10, 26, -15, 21, 19, 11, 15, -26,
+    18, 26, -31, -27, 0, 29, -29, 7, -12, -24, 26, 21, -16, -24, 3, -25, -25, 0, -2, -30,
+    16, -29, -6, -15, -21, -10, 31, 4, 22, -29, -2, 11, 15, -3, -6, -15, 6, 22, -13, 25,
+    -22, -30, -10, 25, -16, 10, -27, -7, -29, 16, -25, -22, -17, -27, 16, 6, -21, 12, 15, 12,
+    -23, -20, 26, 23, -1, -8, 26, -29, 20, -1, 22, 0, -22, 18, -32, 18, -19, 25, 1, 14,
+    -1, -12, -28, -12, 1, 19, 6, 12, -31, 20, 25, -29, -26, -32, -5, 2, -3, 3, 26, -13,
+    1, 15, -29, -13, 11, -16, -17, -10, -1, 14, -19, 29, 19, -27, 13, -9, 30, -28, -15, -5,
+    -27, 7, 20, 2, -28, -12, -8, 4, 30, 24, 17, 25, -28, -1, -13, -21, -24, -11, -4, -2,
+    -1, -32, 1, 31, -9, 26, -6, -19, 31, 16, -20, 11, 15, 28, 26, -32, -5, -30, -22, 21,
+    -5, -20, 25, 12, 24, 6, 30, -31, 22, 25, 31, -31, 4, 8, 22, 13, 4, 12, 2, 13,
+    26, 16, 13, -12, -9, 11, 0, -9, 3, -31, -23, -19, -19, -7, 8, 6, -14, 28, -4, 11,
+    -18, 19, -16, 25, -26, -3, 5, 29, 17, -14, -3, 14, -23, 27, -19, -18, -10, 13, -31, -2,
+    21, -22, 12, 4, 11, -10, -10, -3, 12, -6, -28, -30, 9, 27, 6, 29, -3, -9, -29, 8,
+    -10, 5, 5, -22, -29, -23, -28, -16, -30, 26, 19, -19, 8, -12, -20, 17, -19, 28, -3, -21,
+    -4, 24, -17, 30, -2, -22, -6, -27, -31, -17, 11, 6, 11, -4, -16, 23, -31, -12, 9, -12,
+    21, -23, -17, -4, -13, -8, -31, 14, -21, -29, -13, 6, 28, -20, -11, -9, -27, -9, -28, -24,
+    -22, 29, 19, 15, -24, 15, 23, 15, -7, -15, -11, -16, -26, -14, 12, -30, -16, -19, 2, -15,
+    29, 1, -16, 8, 3, -15, 13, -26, 22, -6, 27, -32, -15, -8, 19, 27, -27, -9, 17, 8,
+    5, 26, 0, 30, -18, -18, 3, 25, 23, 11, -23, -12, 28, -16, 14, -25, 10, 28, 16, -32,
+    -23, -20, -8, 3, 13, -8, -27, -30, 27, -20, -8, -5, 28, -26, 1, -12, 3, 20, -20, 23,
+    -2, 11, -21, 13, -1, -24, -29, 28, 7, -25, 22, -32, -9, 5, 19, 11, 22, 21, 31, 28,
+    -31, -28, -30, -32, 22, 14, 17, -20, -1, 29, 31, 22, -1, -27, -29, -10, 29, -32, 7, 31,
+    20, 10, -10, 29, 22, -4, 3, -18, -28, 9, 26, 1, 15, 26, -25, -16, 11, 9, 8, -4,
+    -7, 0, -13, 12, -15, 16, -25, -27, 17, 16, 20, -24, 7, -4, 9, 15, -32, 9, -31, -26,
+    15, 9, -19, 9, -3, 3, -32, -31, 20, 16, -3, 29, 9, -10, 1, -14, -20, 4, 16, 19,
+};
+
+static const int32_t fc_bias[CLS_CLASSES] = {
+    2000, 17, 1792,
+};
+
+const cls_model_t cls_default_model = {
+    .labels = { "normal", "drift", "fault" },
+    .in_scale = 16.0f,
+    .in_zero_point = -128,
+    .conv_filter = conv_filter,
+    .conv_bias = conv_bias,
+    .conv_mult = conv_mult,
+    .conv_shift = conv_shift,
+    .conv_out_offset = 0,
+    .fc_filter = fc_filter,
+    .fc_bias = fc_bias,
+    .fc_mult = 0x40000000,
+    .fc_shift = -8,
+    .fc_out_offset = 0,
+    .softmax_mult = 1 << 30,
+    .softmax_shift = 22,
+    .softmax_diff_min = -248,
+};
@@ -1,19 +1,53 @@
 #include "cli.h"
 #include "adc.h"
 #include "nvs.h"
+#include "fft.h"
+#include "goertzel.h"
+#include "sched.h"
+#include "pipeline.h"
+#include "nn_bench.h"
+#include "zcross.h"
+#include "classifier.h"
+#include "feat.h"
 #include "esp_console.h"
 #include "argtable3/argtable3.h"
 #include <stdio.h>
+#include <stdarg.h>
+#include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
+#include <fcntl.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_cpu.h"
 #include "driver/uart.h"
 #include "esp_vfs_dev.h"
 
 #define PROMPT "> "
 
+/**
+ * @brief Longest single formatted output chunk
+ */
+#define CLI_LINE_MAX 256
+
+/**
+ * @brief watch refresh period range and default, and keypress poll slice (ms)
+ */
+#define WATCH_MIN_MS 50
+#define WATCH_MAX_MS 10000
+#define WATCH_DEFAULT_MS 500
+#define WATCH_POLL_MS 10
+
+/**
+ * @brief top sampling window range and default (ms), and task list headroom
+ */
+#define TOP_MIN_MS 100
+#define TOP_MAX_MS 10000
+#define TOP_DEFAULT_MS 1000
+#define TOP_TASK_SLACK 4
+
 static struct {
     struct arg_lit *help;
     struct arg_int *channel;
@@ -21,9 +55,140 @@ static struct {
     struct arg_int *max;
     struct arg_int *hyst;
     struct arg_lit *start;
+    struct arg_str *action;
     struct arg_end *end;
 } args;
 
+/**
+ * @brief Longest export/import line, must fit the console command line
+ */
+#define CONFIG_BLOB_MAX 768
+
+/**
+ * @brief Full device configuration as carried by config export/import
+ */
+typedef struct {
+    sched_config_t sched;
+    int block_len;
+    int32_t min[CH_MAX];
+    int32_t max[CH_MAX];
+    int32_t hyst[CH_MAX];
+    int tone_count[CH_MAX];
+    uint32_t tones[CH_MAX][GOERTZEL_MAX_TONES];
+} config_image_t;
+
+static char config_blob[CONFIG_BLOB_MAX];
+
+static struct {
+    struct arg_int *channel;
+    struct arg_int *size;
+    struct arg_lit *rect;
+    struct arg_end *end;
+} fft_args;
+
+static struct {
+    struct arg_int *channel;
+    struct arg_dbl *freq;
+    struct arg_lit *clear;
+    struct arg_int *block;
+    struct arg_end *end;
+} tone_args;
+
+static struct {
+    struct arg_lit *continuous;
+    struct arg_int *interval;
+    struct arg_int *burst;
+    struct arg_lit *reset;
+    struct arg_end *end;
+} power_args;
+
+static struct {
+    struct arg_int *rate;
+    struct arg_end *end;
+} watch_args;
+
+static struct {
+    struct arg_int *window;
+    struct arg_end *end;
+} top_args;
+
+static struct {
+    struct arg_lit *reset;
+    struct arg_end *end;
+} classify_args;
+
+static struct {
+    struct arg_int *size;
+    struct arg_end *end;
+} feat_args;
+
+static struct {
+    struct arg_str *target;
+    struct arg_int *width;
+    struct arg_int *height;
+    struct arg_int *in_ch;
+    struct arg_int *out_ch;
+    struct arg_int *filter;
+    struct arg_int *stride;
+    struct arg_lit *pad;
+    struct arg_end *end;
+} bench_args;
+
+#ifndef CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ
+#define CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ 160
+#endif
+
+/* Largest power of two adc_read_block() can return (below ADC_BUF_LEN) */
+#define FFT_CAPTURE_MAX_N (ADC_BUF_LEN / 2)
+
+/* Blocks are too large for the REPL task stack */
+static int16_t fft_samples[FFT_MAX_N];
+static int16_t fft_work[FFT_MAX_N];
+static uint32_t fft_power[FFT_MAX_N / 2 + 1];
+
+/**
+ * @brief printf into the pipeline output buffer
+ *
+ * Command output is drained to the UART by a separate task, so a slow
+ * console never holds the CPU while acquisition needs it. Output longer
+ * than CLI_LINE_MAX is formatted on the heap rather than truncated.
+ *
+ * @return Bytes dropped because the buffer was full (or memory ran out)
+ */
+static size_t cli_printf(const char *fmt, ...) {
+    char line[CLI_LINE_MAX];
+    va_list ap;
+    va_start(ap, fmt);
+    int len = vsnprintf(line, sizeof(line), fmt, ap);
+    va_end(ap);
+    if (len <= 0) return 0;
+    if (len < sizeof(line)) return len - pipeline_write(line, len);
+
+    char *buf = malloc(len + 1);
+    if (!buf) {
+        /* Keep what fits, report the rest as dropped */
+        return len - pipeline_write(line, sizeof(line) - 1);
+    }
+    va_start(ap, fmt);
+    vsnprintf(buf, len + 1, fmt, ap);
+    va_end(ap);
+    size_t dropped = len - pipeline_write(buf, len);
+    free(buf);
+    return dropped;
+}
+
+/**
+ * @brief Print argtable parse errors through the pipeline like other output
+ */
+static void cli_print_arg_errors(struct arg_end *end, const char *name) {
+    arg_dstr_t ds = arg_dstr_create();
+    if (!ds) return;
+    arg_print_errors_ds(ds, end, name);
+    const char *msg = arg_dstr_cstr(ds);
+    pipeline_write(msg, strlen(msg));
+    arg_dstr_destroy(ds);
+}
+
 /**
  * @brief Scale raw ADC value to configured range with hysteresis
  * @param raw_adc Raw ADC value (0-4095)
@@ -54,11 +219,11 @@ static int scale_adc_value(int raw_adc, int32_t min_val, int32_t max_val,
  * @brief Print channel configuration and current values
  */
 static void print_channel_info(void) {
-    printf("\n=== ADC Channel Configuration ===\n");
+    cli_printf("\n=== ADC Channel Configuration ===\n");
     for (int i = 0; i < CH_MAX; i++) {
-        int32_t min_val = nvs_get_channel_i32("ch_min", i, 0);
-        int32_t max_val = nvs_get_channel_i32("ch_max", i, 4095);
-        int32_t hyst_val = nvs_get_channel_i32("ch_hyst", i, 10);
+        int32_t min_val = nvs_param_get(NVS_PARAM_MIN, i);
+        int32_t max_val = nvs_param_get(NVS_PARAM_MAX, i);
+        int32_t hyst_val = nvs_param_get(NVS_PARAM_HYST, i);
         int raw_adc = adc_filtered[i];
         
         // Map raw ADC (0-4095) to configured range (min-max)
@@ -69,10 +234,13 @@ static void print_channel_info(void) {
             scaled_value = min_val;
         }
         
-        printf("CH%d: min=%4ld, max=%4ld, hyst=%3ld, raw=%4d, scaled=%4d\n",
-               i, min_val, max_val, hyst_val, raw_adc, scaled_value);
+        cli_printf("CH%d: min=%4ld, max=%4ld, hyst=%3ld, raw=%4d, scaled=%4d, "
+               "freq=%lu.%03lu Hz, period=%lu us, duty=%u.%u%%\n",
+               i, min_val, max_val, hyst_val, raw_adc, scaled_value,
+               (unsigned long)(adc_freq_mhz[i] / 1000), (unsigned long)(adc_freq_mhz[i] % 1000),
+               (unsigned long)adc_period_us[i], adc_duty_permille[i] / 10, adc_duty_permille[i] % 10);
     }
-    printf("=================================\n");
+    cli_printf("=================================\n");
 }
 
 /**
@@ -81,33 +249,253 @@ static void print_channel_info(void) {
  */
 static bool validate_config(int ch, int min, int max, int hyst) {
     if (ch < 0 || ch >= CH_MAX) {
-        printf("Error: Channel must be 0-%d\n", CH_MAX-1);
+        cli_printf("Error: Channel must be 0-%d\n", CH_MAX-1);
         return false;
     }
     
     if (min < 0 || min > 4095) {
-        printf("Error: Min must be 0-4095\n");
+        cli_printf("Error: Min must be 0-4095\n");
         return false;
     }
     
     if (max < 0 || max > 4095) {
-        printf("Error: Max must be 0-4095\n");
+        cli_printf("Error: Max must be 0-4095\n");
         return false;
     }
     
     if (hyst < 0 || hyst > 500) {
-        printf("Error: Hysteresis must be 0-500\n");
+        cli_printf("Error: Hysteresis must be 0-500\n");
         return false;
     }
     
     if (min > max) {
-        printf("Error: Min (%d) cannot be greater than Max (%d)\n", min, max);
+        cli_printf("Error: Min (%d) cannot be greater than Max (%d)\n", min, max);
         return false;
     }
     
     return true;
 }
 
+/**
+ * @brief CRC-8 (polynomial 0x07, initial value 0) of a string
+ *
+ * Unlike an XOR sum it catches swapped characters and paired bit flips.
+ */
+static uint8_t config_checksum(const char *str, size_t len) {
+    uint8_t crc = 0;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= (uint8_t)str[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+/**
+ * @brief Serialize the running configuration into one line
+ *
+ * Format: ADC1;S<mode>,<interval_ms>,<burst>;B<block>;
+ *         <min>,<max>,<hyst>[:<tone_mhz>...]; (per channel) *<crc8 hex>
+ *
+ * @return Length written, or -1 if buf is too small
+ */
+static int config_export(char *buf, size_t size) {
+    sched_config_t sched;
+    sched_get_config(&sched);
+
+    int len = snprintf(buf, size, "ADC1;S%d,%lu,%u;B%d;", sched.mode,
+                       (unsigned long)sched.interval_ms, sched.burst_len,
+                       goertzel_get_block_len());
+    for (int ch = 0; ch < CH_MAX && len < size; ch++) {
+        len += snprintf(buf + len, size - len, "%ld,%ld,%ld",
+                        (long)nvs_param_get(NVS_PARAM_MIN, ch),
+                        (long)nvs_param_get(NVS_PARAM_MAX, ch),
+                        (long)nvs_param_get(NVS_PARAM_HYST, ch));
+        int count = goertzel_tone_count(ch);
+        for (int t = 0; t < count && len < size; t++) {
+            len += snprintf(buf + len, size - len, ":%lu",
+                            (unsigned long)goertzel_tone_freq(ch, t));
+        }
+        if (len < size) {
+            len += snprintf(buf + len, size - len, ";");
+        }
+    }
+    if (len < size) {
+        uint8_t sum = config_checksum(buf, len);
+        len += snprintf(buf + len, size - len, "*%02X", sum);
+    }
+    return (len < size) ? len : -1;
+}
+
+/**
+ * @brief Parse one unsigned/signed integer and the separator after it
+ * @return true if a number was read and followed by sep
+ */
+static bool config_parse_num(const char **p, long *val, char sep) {
+    char *end;
+    *val = strtol(*p, &end, 10);
+    if (end == *p || *end != sep) return false;
+    *p = end + 1;
+    return true;
+}
+
+/**
+ * @brief Parse and validate a configuration line without applying it
+ * @return true if every field is present and valid
+ */
+static bool config_parse(const char *blob, config_image_t *img) {
+    const char *star = strrchr(blob, '*');
+    if (strncmp(blob, "ADC1;", 5) != 0 || star == NULL) {
+        cli_printf("Error: Not a configuration line\n");
+        return false;
+    }
+    /* Exactly two hex digits, then the end of the line */
+    char *end;
+    unsigned long sum = strtoul(star + 1, &end, 16);
+    if (!isxdigit((unsigned char)star[1]) || end != star + 3 || *end != '\0') {
+        cli_printf("Error: Malformed checksum\n");
+        return false;
+    }
+    if (sum != config_checksum(blob, star - blob)) {
+        cli_printf("Error: Checksum mismatch\n");
+        return false;
+    }
+
+    const char *p = blob + 5;
+    long mode, interval, burst, block;
+    if (*p++ != 'S' || !config_parse_num(&p, &mode, ',') ||
+        !config_parse_num(&p, &interval, ',') || !config_parse_num(&p, &burst, ';') ||
+        *p++ != 'B' || !config_parse_num(&p, &block, ';')) {
+        cli_printf("Error: Malformed schedule fields\n");
+        return false;
+    }
+    /* Range-check as long first, the narrower fields would wrap (65537 -> 1) */
+    if (mode < SCHED_MODE_CONTINUOUS || mode > SCHED_MODE_LOW_POWER ||
+        interval < 0 || interval > SCHED_MAX_INTERVAL_MS ||
+        burst < 1 || burst > SCHED_MAX_BURST ||
+        block < GOERTZEL_MIN_BLOCK || block > GOERTZEL_MAX_BLOCK) {
+        cli_printf("Error: Invalid schedule or tone block length\n");
+        return false;
+    }
+    img->sched.mode = mode;
+    img->sched.interval_ms = interval;
+    img->sched.burst_len = burst;
+    img->block_len = block;
+    if (!sched_config_valid(&img->sched)) {
+        cli_printf("Error: Invalid schedule or tone block length\n");
+        return false;
+    }
+
+    for (int ch = 0; ch < CH_MAX; ch++) {
+        long min, max, hyst;
+        if (!config_parse_num(&p, &min, ',') || !config_parse_num(&p, &max, ',')) {
+            cli_printf("Error: Malformed fields for CH%d\n", ch);
+            return false;
+        }
+        hyst = strtol(p, &end, 10);
+        if (end == p) {
+            cli_printf("Error: Malformed fields for CH%d\n", ch);
+            return false;
+        }
+        p = end;
+        if (!validate_config(ch, min, max, hyst)) {
+            return false;
+        }
+        img->min[ch] = min;
+        img->max[ch] = max;
+        img->hyst[ch] = hyst;
+
+        img->tone_count[ch] = 0;
+        while (*p == ':') {
+            long tone = strtol(p + 1, &end, 10);
+            if (end == p + 1 || img->tone_count[ch] >= GOERTZEL_MAX_TONES ||
+                tone <= 0 || !goertzel_tone_valid(tone)) {
+                cli_printf("Error: Invalid tone for CH%d\n", ch);
+                return false;
+            }
+            img->tones[ch][img->tone_count[ch]++] = tone;
+            p = end;
+        }
+        if (*p++ != ';') {
+            cli_printf("Error: Malformed fields for CH%d\n", ch);
+            return false;
+        }
+    }
+
+    if (p != star) {
+        cli_printf("Error: Trailing data before checksum\n");
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Apply a validated configuration, persisting it in one NVS commit
+ *
+ * Parameters, schedule, block length and tones go to the config task as
+ * one batch, so a full queue changes nothing.
+ *
+ * @return false if the configuration queue is full
+ */
+static bool config_apply(const config_image_t *img) {
+    /* Too large for the REPL task stack, and only the REPL task gets here */
+    static pipeline_cfg_t items[CH_MAX * 4 + 2];
+    int n = 0;
+    for (int ch = 0; ch < CH_MAX; ch++) {
+        items[n++] = (pipeline_cfg_t){ .param = NVS_PARAM_MIN, .ch = ch, .val = img->min[ch] };
+        items[n++] = (pipeline_cfg_t){ .param = NVS_PARAM_MAX, .ch = ch, .val = img->max[ch] };
+        items[n++] = (pipeline_cfg_t){ .param = NVS_PARAM_HYST, .ch = ch, .val = img->hyst[ch] };
+    }
+    items[n++] = (pipeline_cfg_t){ .kind = PIPELINE_CFG_SCHED, .sched = img->sched };
+    items[n++] = (pipeline_cfg_t){ .kind = PIPELINE_CFG_BLOCK_LEN, .val = img->block_len };
+    for (int ch = 0; ch < CH_MAX; ch++) {
+        pipeline_cfg_t *t = &items[n++];
+        *t = (pipeline_cfg_t){ .kind = PIPELINE_CFG_TONES, .ch = ch };
+        t->tones.count = img->tone_count[ch];
+        memcpy(t->tones.freq_mhz, img->tones[ch], sizeof(t->tones.freq_mhz));
+    }
+    return pipeline_post_config_batch(items, n);
+}
+
+/**
+ * @brief config export / config import <line>
+ */
+static int cmd_config_action(struct arg_str *action) {
+    const char *verb = action->sval[0];
+
+    if (strcmp(verb, "export") == 0 && action->count == 1) {
+        int len = config_export(config_blob, sizeof(config_blob));
+        if (len < 0) {
+            cli_printf("Error: Configuration does not fit in %d bytes\n", CONFIG_BLOB_MAX);
+            return 1;
+        }
+        pipeline_write(config_blob, len);
+        pipeline_write("\n", 1);
+        return 0;
+    }
+
+    if (strcmp(verb, "import") == 0 && action->count == 2) {
+        static config_image_t img;
+        int64_t start = esp_timer_get_time();
+        if (!config_parse(action->sval[1], &img)) {
+            cli_printf("Import rejected, nothing changed\n");
+            return 1;
+        }
+        if (!config_apply(&img)) {
+            cli_printf("Error: Configuration queue full, nothing changed, retry\n");
+            return 1;
+        }
+        /* The NVS commit itself runs later in the config task */
+        cli_printf("Import validated and queued in %lld us, config task persists it\n",
+                   esp_timer_get_time() - start);
+        return 0;
+    }
+
+    cli_printf("Usage: config export | config import <line>\n");
+    return 1;
+}
+
 /**
  * @brief Configuration command handler
  */
@@ -115,10 +503,15 @@ static int cmd_config(int argc, char **argv) {
     int nerrors = arg_parse(argc, argv, (void *)&args);
     
     if (nerrors != 0) {
-        arg_print_errors(stderr, args.end, argv[0]);
+        cli_print_arg_errors(args.end, argv[0]);
         return 1;
     }
 
+    // Bulk export/import
+    if (args.action->count > 0) {
+        return cmd_config_action(args.action);
+    }
+
     // Show start information
     if (args.start->count > 0) {
         print_channel_info();
@@ -128,7 +521,7 @@ static int cmd_config(int argc, char **argv) {
     // Check if channel is required for other operations
     if ((args.min->count > 0 || args.max->count > 0 || args.hyst->count > 0) && 
         args.channel->count == 0) {
-        printf("Error: Channel (-c) is required when setting min/max/hyst\n");
+        cli_printf("Error: Channel (-c) is required when setting min/max/hyst\n");
         return 1;
     }
 
@@ -137,14 +530,14 @@ static int cmd_config(int argc, char **argv) {
         int ch = args.channel->ival[0];
         
         if (ch < 0 || ch >= CH_MAX) {
-            printf("Error: Invalid channel. Must be 0-%d\n", CH_MAX-1);
+            cli_printf("Error: Invalid channel. Must be 0-%d\n", CH_MAX-1);
             return 1;
         }
 
-        // Get current values from NVS
-        int current_min = nvs_get_channel_i32("ch_min", ch, 0);
-        int current_max = nvs_get_channel_i32("ch_max", ch, 4095);
-        int current_hyst = nvs_get_channel_i32("ch_hyst", ch, 10);
+        // Get current values from the NVS cache
+        int current_min = nvs_param_get(NVS_PARAM_MIN, ch);
+        int current_max = nvs_param_get(NVS_PARAM_MAX, ch);
+        int current_hyst = nvs_param_get(NVS_PARAM_HYST, ch);
         
         // Apply new values if provided
         int new_min = (args.min->count > 0) ? args.min->ival[0] : current_min;
@@ -156,31 +549,40 @@ static int cmd_config(int argc, char **argv) {
             return 1;
         }
 
-        // Save new values to NVS
-        bool changed = false;
-        
+        // Queue new values as one batch; the config task applies and persists them
+        pipeline_cfg_t items[3];
+        int n = 0;
+
         if (new_min != current_min) {
-            nvs_set_channel_i32("ch_min", ch, new_min);
-            printf("CH%d min set to %d\n", ch, new_min);
-            changed = true;
+            items[n++] = (pipeline_cfg_t){ .param = NVS_PARAM_MIN, .ch = ch, .val = new_min };
         }
-        
         if (new_max != current_max) {
-            nvs_set_channel_i32("ch_max", ch, new_max);
-            printf("CH%d max set to %d\n", ch, new_max);
-            changed = true;
+            items[n++] = (pipeline_cfg_t){ .param = NVS_PARAM_MAX, .ch = ch, .val = new_max };
         }
-        
         if (new_hyst != current_hyst) {
-            nvs_set_channel_i32("ch_hyst", ch, new_hyst);
-            printf("CH%d hysteresis set to %d\n", ch, new_hyst);
-            changed = true;
+            items[n++] = (pipeline_cfg_t){ .param = NVS_PARAM_HYST, .ch = ch, .val = new_hyst };
         }
-        
+        bool changed = n > 0;
+
+        if (changed && !pipeline_post_config_batch(items, n)) {
+            cli_printf("Error: Configuration queue full, retry\n");
+            return 1;
+        }
+
+        if (new_min != current_min) {
+            cli_printf("CH%d min set to %d\n", ch, new_min);
+        }
+        if (new_max != current_max) {
+            cli_printf("CH%d max set to %d\n", ch, new_max);
+        }
+        if (new_hyst != current_hyst) {
+            cli_printf("CH%d hysteresis set to %d\n", ch, new_hyst);
+        }
+
         if (changed) {
-            printf("Changes saved to NVS for CH%d\n", ch);
+            cli_printf("Changes queued for NVS for CH%d\n", ch);
         } else {
-            printf("No changes made for CH%d\n", ch);
+            cli_printf("No changes made for CH%d\n", ch);
         }
     }
 
@@ -197,6 +599,7 @@ static void register_config_command(void) {
     args.max = arg_intn("M", "max", "<val>", 0, 1, "Maximum value (0-4095)");
     args.hyst = arg_intn("H", "hyst", "<val>", 0, 1, "Hysteresis (0-500)");
     args.start = arg_litn("s", "start", 0, 1, "Show channel information");
+    args.action = arg_strn(NULL, NULL, "export|import <line>", 0, 2, "Bulk configuration transfer");
     args.end = arg_end(10);
 
     esp_console_cmd_t cmd = {
@@ -210,8 +613,950 @@ static void register_config_command(void) {
     esp_console_cmd_register(&cmd);
 }
 
+/**
+ * @brief Spectrum command handler
+ */
+static int cmd_fft(int argc, char **argv) {
+    int nerrors = arg_parse(argc, argv, (void *)&fft_args);
+
+    if (nerrors != 0) {
+        cli_print_arg_errors(fft_args.end, argv[0]);
+        return 1;
+    }
+
+    int ch = fft_args.channel->ival[0];
+    int n = (fft_args.size->count > 0) ? fft_args.size->ival[0] : FFT_MIN_N;
+    fft_window_t win = (fft_args.rect->count > 0) ? FFT_WINDOW_RECT : FFT_WINDOW_HANN;
+
+    if (!check_channel(ch)) {
+        cli_printf("Error: Invalid channel. Must be 0-%d\n", CH_MAX-1);
+        return 1;
+    }
+
+    if (!fft_size_valid(n) || n > FFT_CAPTURE_MAX_N) {
+        cli_printf("Error: Size must be a power of two in %d-%d\n", FFT_MIN_N, FFT_CAPTURE_MAX_N);
+        return 1;
+    }
+
+    if (adc_read_block(ch, fft_samples, n) < 0) {
+        cli_printf("Error: No intact window of CH%d samples yet\n", ch);
+        return 1;
+    }
+
+    fft_power_spectrum(fft_samples, n, win, fft_work, fft_power);
+
+    uint32_t rate_mhz = sched_sample_rate_mhz();
+    cli_printf("CH%d spectrum, n=%d, %s window\n", ch, n,
+           win == FFT_WINDOW_HANN ? "hann" : "rect");
+    for (int k = 0; k <= n / 2; k++) {
+        uint32_t freq_mhz = (uint32_t)(((uint64_t)k * rate_mhz) / n);
+        cli_printf("%4d %5lu.%03lu Hz %10lu\n", k, (unsigned long)(freq_mhz / 1000),
+               (unsigned long)(freq_mhz % 1000), (unsigned long)fft_power[k]);
+    }
+    return 0;
+}
+
+/**
+ * @brief Report FFT throughput for every supported size
+ */
+static void bench_fft(void) {
+    const int iters = 50;
+
+    /* Synthetic tone so the result does not depend on acquisition state */
+    for (int i = 0; i < FFT_MAX_N; i++) {
+        fft_samples[i] = 2048 + ((i & 8) ? 1000 : -1000);
+    }
+
+    cli_printf("FFT benchmark (%d iterations per size)\n", iters);
+    for (int n = FFT_MIN_N; n <= FFT_MAX_N; n <<= 1) {
+        int64_t start = esp_timer_get_time();
+        for (int i = 0; i < iters; i++) {
+            fft_power_spectrum(fft_samples, n, FFT_WINDOW_HANN, fft_work, fft_power);
+        }
+        int64_t elapsed = esp_timer_get_time() - start;
+        if (elapsed <= 0) elapsed = 1;
+        cli_printf("n=%4d: %6lld us/fft, %6lld fft/s\n", n, elapsed / iters,
+               (iters * 1000000LL) / elapsed);
+    }
+}
+
+/**
+ * @brief Compare a Goertzel bank against a full FFT on the same block
+ */
+static void bench_goertzel(void) {
+    const int n = 256;
+    const int iters = 50;
+    const int tone_counts[] = {1, 2, 4, 8};
+
+    for (int i = 0; i < n; i++) {
+        fft_samples[i] = 2048 + ((i & 8) ? 1000 : -1000);
+    }
+
+    int64_t start = esp_timer_get_time();
+    for (int i = 0; i < iters; i++) {
+        fft_power_spectrum(fft_samples, n, FFT_WINDOW_HANN, fft_work, fft_power);
+    }
+    int64_t fft_us = esp_timer_get_time() - start;
+    if (fft_us <= 0) fft_us = 1;
+    cli_printf("Goertzel vs FFT, block of %d samples (%d iterations)\n", n, iters);
+    cli_printf("fft:        %6lld us/block\n", fft_us / iters);
+
+    /* Private bank: the channel banks and block length stay untouched */
+    static goertzel_bank_t bank;
+    for (int c = 0; c < sizeof(tone_counts) / sizeof(tone_counts[0]); c++) {
+        goertzel_bank_clear(&bank);
+        for (int t = 0; t < tone_counts[c]; t++) {
+            goertzel_bank_add_tone(&bank, (ADC_SAMPLE_RATE_MHZ / 2) * (t + 1) / (GOERTZEL_MAX_TONES + 1));
+        }
+        start = esp_timer_get_time();
+        for (int i = 0; i < iters; i++) {
+            for (int k = 0; k < n; k++) {
+                goertzel_bank_update(&bank, fft_samples[k], n);
+            }
+        }
+        int64_t us = esp_timer_get_time() - start;
+        cli_printf("goertzel x%d: %6lld us/block, %3lld%% of fft\n", tone_counts[c],
+               us / iters, (us * 100) / fft_us);
+    }
+}
+
+/**
+ * @brief Model the energy proxy of several schedules from measured costs
+ */
+static void bench_power(void) {
+    const uint32_t intervals[] = {1000, 10000, 60000};
+    const uint16_t bursts[] = {1, 16, 64};
+
+    uint32_t sample_us = adc_sample_cost_us(100);
+
+    /* Wake overhead: measured active time per wake minus its samples */
+    sched_config_t cur;
+    sched_stats_t st;
+    sched_get_config(&cur);
+    sched_get_stats(&st);
+    uint32_t wake_us = 0;
+    if (st.wakes > 0) {
+        uint32_t per_wake = (uint32_t)(st.active_us / st.wakes);
+        uint32_t samples = sample_us * (cur.mode == SCHED_MODE_LOW_POWER ? cur.burst_len : 1);
+        wake_us = per_wake > samples ? per_wake - samples : 0;
+    }
+
+    cli_printf("Energy proxy model: %lu us/sample round, %lu us/wake overhead\n",
+           (unsigned long)sample_us, (unsigned long)wake_us);
+
+    sched_config_t cfg = { .mode = SCHED_MODE_CONTINUOUS };
+    cli_printf("continuous %5d ms:          %8lu active ms/h\n", ADC_PERIOD_MS,
+           (unsigned long)sched_model_active_ms_per_hour(&cfg, wake_us, sample_us));
+
+    cfg.mode = SCHED_MODE_LOW_POWER;
+    for (int i = 0; i < sizeof(intervals) / sizeof(intervals[0]); i++) {
+        for (int b = 0; b < sizeof(bursts) / sizeof(bursts[0]); b++) {
+            cfg.interval_ms = intervals[i];
+            cfg.burst_len = bursts[b];
+            cli_printf("low-power  %5lu ms burst %2u: %8lu active ms/h\n",
+                   (unsigned long)cfg.interval_ms, cfg.burst_len,
+                   (unsigned long)sched_model_active_ms_per_hour(&cfg, wake_us, sample_us));
+        }
+    }
+}
+
+/**
+ * @brief Compare cached parameter lookups with the old sprintf + flash path
+ */
+static void bench_nvs(void) {
+    static const char *const prefixes[] = {"ch_min", "ch_max", "ch_hyst"};
+    const int iters = 200;
+    volatile int32_t sink = 0;
+    char key[16];
+
+    int64_t start = esp_timer_get_time();
+    for (int i = 0; i < iters; i++) {
+        for (int p = NVS_PARAM_MIN; p <= NVS_PARAM_HYST; p++) {
+            for (int ch = 0; ch < CH_MAX; ch++) {
+                sprintf(key, "%s%d", prefixes[p], ch);
+                sink += nvs_param_read_raw(p, ch) + key[0];
+            }
+        }
+    }
+    int64_t legacy_us = esp_timer_get_time() - start;
+
+    start = esp_timer_get_time();
+    for (int i = 0; i < iters; i++) {
+        for (int p = NVS_PARAM_MIN; p <= NVS_PARAM_HYST; p++) {
+            for (int ch = 0; ch < CH_MAX; ch++) {
+                sink += nvs_param_get(p, ch);
+            }
+        }
+    }
+    int64_t cached_us = esp_timer_get_time() - start;
+    if (cached_us <= 0) cached_us = 1;
+
+    int lookups = iters * 3 * CH_MAX;
+    cli_printf("NVS lookups (%d per path)\n", lookups);
+    cli_printf("sprintf + nvs_get_i32: %8lld ns/lookup\n", (legacy_us * 1000) / lookups);
+    cli_printf("nvs_param_get:         %8lld ns/lookup (%lldx faster)\n",
+           (cached_us * 1000) / lookups, legacy_us / cached_us);
+}
+
+/**
+ * @brief Measure acquisition wake jitter with an idle and a busy console
+ */
+static void bench_jitter(void) {
+    const int phase_ms = 5000;
+    sched_stats_t idle, busy;
+
+    cli_printf("Measuring wake jitter, %d ms idle then %d ms busy console...\n",
+               phase_ms, phase_ms);
+
+    sched_reset_stats();
+    vTaskDelay(pdMS_TO_TICKS(phase_ms));
+    sched_get_stats(&idle);
+
+    /*
+     * Busy: full table dumps plus config task wakes. The messages are pings,
+     * so nothing is written to flash, and a tick of yield per round keeps
+     * the idle task (and its watchdog) fed.
+     */
+    sched_reset_stats();
+    int64_t end = esp_timer_get_time() + phase_ms * 1000LL;
+    while (esp_timer_get_time() < end) {
+        print_channel_info();
+        pipeline_ping_config();
+        vTaskDelay(1);
+    }
+    sched_get_stats(&busy);
+
+    const sched_stats_t *phases[] = {&idle, &busy};
+    const char *names[] = {"idle", "busy"};
+    for (int i = 0; i < 2; i++) {
+        const sched_stats_t *st = phases[i];
+        cli_printf("%s: wakes=%lu, jitter max=%lu us, mean=%lu us\n", names[i],
+                   (unsigned long)st->wakes, (unsigned long)st->jitter_max_us,
+                   (unsigned long)(st->wakes > 1 ? st->jitter_sum_us / (st->wakes - 1) : 0));
+    }
+}
+
+/**
+ * @brief Run one esp-nn kernel, ANSI against optimized
+ */
+static int bench_nn_kernel(nn_bench_kernel_t kernel, bool use_args) {
+    nn_bench_shape_t shape;
+    nn_bench_result_t res;
+    nn_bench_default_shape(kernel, &shape);
+
+    if (use_args) {
+        if (bench_args.width->count) shape.width = bench_args.width->ival[0];
+        if (bench_args.height->count) shape.height = bench_args.height->ival[0];
+        if (bench_args.in_ch->count) shape.in_ch = bench_args.in_ch->ival[0];
+        if (bench_args.out_ch->count) shape.out_ch = bench_args.out_ch->ival[0];
+        if (bench_args.filter->count) shape.filter = bench_args.filter->ival[0];
+        if (bench_args.stride->count) shape.stride = bench_args.stride->ival[0];
+        if (bench_args.pad->count) shape.pad = 1;
+    }
+
+    esp_err_t err = nn_bench_run(kernel, &shape, &res);
+    if (err != ESP_OK) {
+        cli_printf("%-8s error: %s\n", nn_bench_name(kernel),
+                   err == ESP_ERR_NO_MEM ? "out of memory" : "invalid shape");
+        return 1;
+    }
+
+    uint32_t opt = res.opt_cycles ? res.opt_cycles : 1;
+    uint32_t ansi = res.ansi_cycles ? res.ansi_cycles : 1;
+    cli_printf("%-8s %3dx%-3d in %3d out %3d f %d s %d%s | ansi %9lu opt %9lu cycles, "
+               "ratio %lu.%02lu, %llu Mop/s%s\n",
+               nn_bench_name(kernel), shape.width, shape.height, shape.in_ch, shape.out_ch,
+               shape.filter, shape.stride, shape.pad ? " pad" : "",
+               (unsigned long)res.ansi_cycles, (unsigned long)res.opt_cycles,
+               (unsigned long)(ansi / opt), (unsigned long)((ansi % opt) * 100 / opt),
+               (unsigned long long)(res.ops * CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ / opt),
+               res.exact ? "" : " MISMATCH");
+    return res.exact ? 0 : 1;
+}
+
+/**
+ * @brief Cycles per sample of each ADC processing stage
+ *
+ * Goertzel and zero-crossing run on private state set up like the last
+ * channel's, so the live estimators that adc_task updates are left alone.
+ */
+static void bench_adc(void) {
+    const int n = 1024;
+    const int ch = CH_MAX - 1;
+    int avg = 0, filtered = 0;
+    zc_result_t zc;
+    static goertzel_bank_t bank;
+    static zc_state_t zc_state;
+
+    for (int i = 0; i < n; i++) {
+        fft_samples[i] = 2048 + ((i & 8) ? 1000 : -1000);
+    }
+
+    goertzel_bank_clear(&bank);
+    int tones = goertzel_tone_count(ch);
+    for (int t = 0; t < tones; t++) {
+        goertzel_bank_add_tone(&bank, goertzel_tone_freq(ch, t));
+    }
+    memset(&zc_state, 0, sizeof(zc_state));
+    int block_len = goertzel_get_block_len();
+
+    uint32_t start = esp_cpu_get_cycle_count();
+    for (int i = 0; i < n; i++) {
+        adc_filter_sample(&avg, &filtered, fft_samples[i], false, 10, 0, 4095);
+    }
+    uint32_t filter_cycles = esp_cpu_get_cycle_count() - start;
+
+    start = esp_cpu_get_cycle_count();
+    for (int i = 0; i < n; i++) {
+        goertzel_bank_update(&bank, fft_samples[i], block_len);
+    }
+    uint32_t goertzel_cycles = esp_cpu_get_cycle_count() - start;
+
+    start = esp_cpu_get_cycle_count();
+    for (int i = 0; i < n; i++) {
+        zcross_state_update(&zc_state, fft_samples[i], &zc);
+    }
+    uint32_t zcross_cycles = esp_cpu_get_cycle_count() - start;
+
+    start = esp_cpu_get_cycle_count();
+    fft_power_spectrum(fft_samples, n, FFT_WINDOW_HANN, fft_work, fft_power);
+    uint32_t fft_cycles = esp_cpu_get_cycle_count() - start;
+
+    cli_printf("ADC stages, cycles per sample (%d samples, CH%d)\n", n, ch);
+    cli_printf("filter:       %6lu\n", (unsigned long)(filter_cycles / n));
+    cli_printf("goertzel x%d:  %6lu\n", bank.count, (unsigned long)(goertzel_cycles / n));
+    cli_printf("zero-cross:   %6lu\n", (unsigned long)(zcross_cycles / n));
+    cli_printf("fft %d:     %6lu\n", n, (unsigned long)(fft_cycles / n));
+}
+
+/**
+ * @brief Benchmark command handler
+ */
+static int cmd_bench(int argc, char **argv) {
+    int nerrors = arg_parse(argc, argv, (void *)&bench_args);
+
+    if (nerrors != 0) {
+        cli_print_arg_errors(bench_args.end, argv[0]);
+        return 1;
+    }
+
+    const char *target = bench_args.target->sval[0];
+    if (strcmp(target, "fft") == 0) {
+        bench_fft();
+    } else if (strcmp(target, "goertzel") == 0) {
+        bench_goertzel();
+    } else if (strcmp(target, "power") == 0) {
+        bench_power();
+    } else if (strcmp(target, "nvs") == 0) {
+        bench_nvs();
+    } else if (strcmp(target, "jitter") == 0) {
+        bench_jitter();
+    } else if (strcmp(target, "adc") == 0) {
+        bench_adc();
+    } else if (strcmp(target, "nn") == 0) {
+        int failed = 0;
+        for (int k = 0; k < NN_BENCH_COUNT; k++) {
+            failed |= bench_nn_kernel(k, false);
+        }
+        return failed;
+    } else if (nn_bench_lookup(target) != NN_BENCH_COUNT) {
+        return bench_nn_kernel(nn_bench_lookup(target), true);
+    } else {
+        cli_printf("Error: Unknown benchmark '%s'\n", target);
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Tone detection command handler
+ */
+static int cmd_tone(int argc, char **argv) {
+    int nerrors = arg_parse(argc, argv, (void *)&tone_args);
+
+    if (nerrors != 0) {
+        cli_print_arg_errors(tone_args.end, argv[0]);
+        return 1;
+    }
+
+    /* Block length and tones go to the config task as one batch */
+    pipeline_cfg_t items[2];
+    int n = 0;
+
+    if (tone_args.block->count > 0) {
+        int len = tone_args.block->ival[0];
+        if (len < GOERTZEL_MIN_BLOCK || len > GOERTZEL_MAX_BLOCK) {
+            cli_printf("Error: Block length must be %d-%d\n", GOERTZEL_MIN_BLOCK, GOERTZEL_MAX_BLOCK);
+            return 1;
+        }
+        items[n++] = (pipeline_cfg_t){ .kind = PIPELINE_CFG_BLOCK_LEN, .val = len };
+    }
+
+    if ((tone_args.freq->count > 0 || tone_args.clear->count > 0) &&
+        tone_args.channel->count == 0) {
+        cli_printf("Error: Channel (-c) is required when adding or clearing tones\n");
+        return 1;
+    }
+
+    int ch = (tone_args.channel->count > 0) ? tone_args.channel->ival[0] : 0;
+    if (!check_channel(ch)) {
+        cli_printf("Error: Invalid channel. Must be 0-%d\n", CH_MAX-1);
+        return 1;
+    }
+
+    /* The whole new tone list, so the bank restarts its block once */
+    if (tone_args.clear->count > 0 || tone_args.freq->count > 0) {
+        pipeline_cfg_t *t = &items[n++];
+        *t = (pipeline_cfg_t){ .kind = PIPELINE_CFG_TONES, .ch = ch };
+        if (tone_args.clear->count == 0) {
+            t->tones.count = goertzel_tone_count(ch);
+            for (int i = 0; i < t->tones.count; i++) {
+                t->tones.freq_mhz[i] = goertzel_tone_freq(ch, i);
+            }
+        }
+
+        for (int i = 0; i < tone_args.freq->count; i++) {
+            double hz = tone_args.freq->dval[i];
+            uint32_t freq_mhz = (hz > 0) ? (uint32_t)(hz * 1000.0 + 0.5) : 0;
+            if (t->tones.count >= GOERTZEL_MAX_TONES || !goertzel_tone_valid(freq_mhz)) {
+                cli_printf("Error: Cannot add %.3f Hz to CH%d (max %d tones, below %d.%03d Hz)\n",
+                       hz, ch, GOERTZEL_MAX_TONES, ADC_SAMPLE_RATE_MHZ / 2000,
+                       (ADC_SAMPLE_RATE_MHZ / 2) % 1000);
+                return 1;
+            }
+            t->tones.freq_mhz[t->tones.count++] = freq_mhz;
+        }
+    }
+
+    if (n > 0 && !pipeline_post_config_batch(items, n)) {
+        cli_printf("Error: Configuration queue full, retry\n");
+        return 1;
+    }
+
+    if (tone_args.block->count > 0) {
+        cli_printf("Tone block length set to %d\n", tone_args.block->ival[0]);
+    }
+    if (tone_args.clear->count > 0) {
+        cli_printf("CH%d tones cleared\n", ch);
+    }
+    for (int i = 0; i < tone_args.freq->count; i++) {
+        cli_printf("CH%d tone %.3f Hz added\n", ch, tone_args.freq->dval[i]);
+    }
+
+    cli_printf("=== Tone Detection (block %d) ===\n", goertzel_get_block_len());
+    for (int ch = 0; ch < CH_MAX; ch++) {
+        int count = goertzel_tone_count(ch);
+        for (int t = 0; t < count; t++) {
+            uint32_t freq_mhz = goertzel_tone_freq(ch, t);
+            cli_printf("CH%d: %5lu.%03lu Hz power=%lu\n", ch,
+                   (unsigned long)(freq_mhz / 1000), (unsigned long)(freq_mhz % 1000),
+                   (unsigned long)goertzel_tone_power(ch, t));
+        }
+    }
+    cli_printf("=================================\n");
+    return 0;
+}
+
+/**
+ * @brief Acquisition mode command handler
+ */
+static int cmd_power(int argc, char **argv) {
+    int nerrors = arg_parse(argc, argv, (void *)&power_args);
+
+    if (nerrors != 0) {
+        cli_print_arg_errors(power_args.end, argv[0]);
+        return 1;
+    }
+
+    sched_config_t cfg;
+    sched_get_config(&cfg);
+
+    if (power_args.continuous->count > 0) {
+        cfg.mode = SCHED_MODE_CONTINUOUS;
+    } else if (power_args.interval->count > 0 || power_args.burst->count > 0) {
+        cfg.mode = SCHED_MODE_LOW_POWER;
+    }
+
+    /* Range-check as int first, the narrower fields would wrap (65537 -> 1) */
+    int ms = (power_args.interval->count > 0) ? power_args.interval->ival[0] : (int)cfg.interval_ms;
+    int burst = (power_args.burst->count > 0) ? power_args.burst->ival[0] : cfg.burst_len;
+    bool in_range = ms >= 0 && ms <= SCHED_MAX_INTERVAL_MS && burst >= 1 && burst <= SCHED_MAX_BURST;
+    if (in_range) {
+        cfg.interval_ms = (uint32_t)ms;
+        cfg.burst_len = (uint16_t)burst;
+    }
+
+    if (!in_range || !sched_config_valid(&cfg)) {
+        cli_printf("Error: Interval must be %d-%d ms, burst 1-%d\n",
+               SCHED_MIN_INTERVAL_MS, SCHED_MAX_INTERVAL_MS, SCHED_MAX_BURST);
+        return 1;
+    }
+
+    bool changed = power_args.continuous->count > 0 || power_args.interval->count > 0 ||
+                   power_args.burst->count > 0;
+    pipeline_cfg_t item = { .kind = PIPELINE_CFG_SCHED, .sched = cfg };
+    if (changed && !pipeline_post_config_batch(&item, 1)) {
+        cli_printf("Error: Configuration queue full, retry\n");
+        return 1;
+    }
+
+    if (power_args.reset->count > 0) {
+        sched_reset_stats();
+    }
+
+    sched_stats_t st;
+    sched_get_stats(&st);
+
+    cli_printf("=== Acquisition Power ===\n");
+    if (cfg.mode == SCHED_MODE_LOW_POWER) {
+        cli_printf("mode: low-power, interval=%lu ms, burst=%u\n",
+               (unsigned long)cfg.interval_ms, cfg.burst_len);
+    } else {
+        cli_printf("mode: continuous, period=%d ms\n", ADC_PERIOD_MS);
+    }
+    cli_printf("wakes=%lu, active=%llu us over %llu ms\n", (unsigned long)st.wakes,
+           (unsigned long long)st.active_us, (unsigned long long)(st.elapsed_us / 1000));
+    cli_printf("active ms per hour: %lu\n", (unsigned long)sched_active_ms_per_hour(&st));
+    cli_printf("wake jitter: max=%lu us, mean=%lu us\n", (unsigned long)st.jitter_max_us,
+               (unsigned long)(st.wakes > 1 ? st.jitter_sum_us / (st.wakes - 1) : 0));
+    cli_printf("=========================\n");
+    return 0;
+}
+
+/**
+ * @brief Classifier status command handler
+ */
+static int cmd_classify(int argc, char **argv) {
+    int nerrors = arg_parse(argc, argv, (void *)&classify_args);
+
+    if (nerrors != 0) {
+        cli_print_arg_errors(classify_args.end, argv[0]);
+        return 1;
+    }
+
+    if (!classifier_running()) {
+        cli_printf("Classifier not running: enable CONFIG_APP_CLASSIFIER with a trained model\n");
+        return 1;
+    }
+
+    if (classify_args.reset->count > 0) {
+        classifier_reset_stats();
+    }
+
+    cls_result_t res;
+    cls_stats_t st;
+    classifier_get(&res);
+    classifier_get_stats(&st);
+
+    cli_printf("=== Classifier ===\n");
+    if (res.seq == 0) {
+        cli_printf("no decision yet (window %d samples, hop %d)\n", CLS_WINDOW, CLS_HOP);
+    } else {
+        cli_printf("decision #%lu: %s\n", (unsigned long)res.seq, classifier_label(res.top));
+        for (int i = 0; i < CLS_CLASSES; i++) {
+            cli_printf("  %-8s %3d%%\n", classifier_label(i), (res.prob[i] + 128) * 100 / 256);
+        }
+        cli_printf("latency: %lu us\n", (unsigned long)res.latency_us);
+    }
+
+    int64_t window_us = esp_timer_get_time() - st.since_us;
+    uint32_t n = st.inferences ? st.inferences : 1;
+    cli_printf("inferences=%lu, dropped=%lu over %llu ms\n", (unsigned long)st.inferences,
+               (unsigned long)st.dropped, (unsigned long long)(window_us / 1000));
+    uint64_t rate_milli = window_us > 0 ? (uint64_t)st.inferences * 1000000000ULL / window_us : 0;
+    cli_printf("rate: %llu.%03llu inferences/s\n", (unsigned long long)(rate_milli / 1000),
+               (unsigned long long)(rate_milli % 1000));
+    cli_printf("inference: mean=%lu us, max=%lu us\n",
+               (unsigned long)(st.infer_us_sum / n), (unsigned long)st.infer_us_max);
+    cli_printf("sample to decision: mean=%lu us, max=%lu us\n",
+               (unsigned long)(st.latency_us_sum / n), (unsigned long)st.latency_us_max);
+    cli_printf("==================\n");
+    return 0;
+}
+
+/**
+ * @brief Feature vector command handler
+ */
+static int cmd_feat(int argc, char **argv) {
+    int nerrors = arg_parse(argc, argv, (void *)&feat_args);
+
+    if (nerrors != 0) {
+        cli_print_arg_errors(feat_args.end, argv[0]);
+        return 1;
+    }
+
+    int n = (feat_args.size->count > 0) ? feat_args.size->ival[0] : FEAT_MAX_WINDOW;
+    if (!fft_size_valid(n) || n > FEAT_MAX_WINDOW) {
+        cli_printf("Error: Window must be a power of two, %d-%d\n", FFT_MIN_N, FEAT_MAX_WINDOW);
+        return 1;
+    }
+
+    static int8_t vec[FEAT_LEN];
+    int64_t start = esp_timer_get_time();
+    if (feat_frame(n, vec) < 0) {
+        cli_printf("Error: Not enough samples acquired yet\n");
+        return 1;
+    }
+    uint32_t elapsed = (uint32_t)(esp_timer_get_time() - start);
+
+    cli_printf("=== Features (%d samples) ===\n", n);
+    cli_printf("CH ");
+    for (int f = 0; f < FEAT_PER_CH; f++) cli_printf(" %6s", feat_name(f));
+    cli_printf("\n");
+    for (int ch = 0; ch < CH_MAX; ch++) {
+        cli_printf("%d: ", ch);
+        for (int f = 0; f < FEAT_PER_CH; f++) cli_printf(" %6d", vec[ch * FEAT_PER_CH + f]);
+        cli_printf("\n");
+    }
+    cli_printf("%d int8 features in %lu us\n", FEAT_LEN, (unsigned long)elapsed);
+    return 0;
+}
+
+/* Fixed parts of a watch line, so the loop only converts integers */
+static const char *const watch_prefix[CH_MAX] = {"CH0 val=", "CH1 val=", "CH2 val=",
+                                                 "CH3 val=", "CH4 val=", "CH5 val="};
+static const char watch_freq[] = " freq=";
+static const char watch_mhz[] = " mHz\n";
+
+/**
+ * @brief Append a fixed string, return the new end
+ */
+static inline char *watch_put(char *p, const char *str, size_t len) {
+    memcpy(p, str, len);
+    return p + len;
+}
+
+/**
+ * @brief Append a signed integer in decimal, return the new end
+ */
+static char *watch_put_int(char *p, int32_t v) {
+    char tmp[11];
+    int n = 0;
+    uint32_t u = v < 0 ? -(uint32_t)v : (uint32_t)v;
+    if (v < 0) *p++ = '-';
+    do {
+        tmp[n++] = '0' + u % 10;
+        u /= 10;
+    } while (u);
+    while (n) *p++ = tmp[--n];
+    return p;
+}
+
+/**
+ * @brief Wait up to ms for a keypress, return true if one arrived
+ *
+ * Polls stdin rather than a UART driver so USB-CDC and USB-Serial-JTAG
+ * consoles work too; stdin must be non-blocking.
+ */
+static bool watch_wait_key(int ms) {
+    for (int waited = 0; waited < ms; waited += WATCH_POLL_MS) {
+        if (fgetc(stdin) != EOF) return true;
+        clearerr(stdin);
+        vTaskDelay(pdMS_TO_TICKS(WATCH_POLL_MS));
+    }
+    return false;
+}
+
+/**
+ * @brief Live view command handler
+ *
+ * Prints only channels whose filtered value or frequency changed since the
+ * previous refresh. Reads the in-memory state, never NVS. Any key exits.
+ */
+static int cmd_watch(int argc, char **argv) {
+    int nerrors = arg_parse(argc, argv, (void *)&watch_args);
+
+    if (nerrors != 0) {
+        cli_print_arg_errors(watch_args.end, argv[0]);
+        return 1;
+    }
+
+    int period_ms = (watch_args.rate->count > 0) ? watch_args.rate->ival[0] : WATCH_DEFAULT_MS;
+    if (period_ms < WATCH_MIN_MS || period_ms > WATCH_MAX_MS) {
+        cli_printf("Error: Refresh period must be %d-%d ms\n", WATCH_MIN_MS, WATCH_MAX_MS);
+        return 1;
+    }
+
+    cli_printf("Watching every %d ms, press any key to stop\n", period_ms);
+
+    int last_val[CH_MAX];
+    uint32_t last_freq[CH_MAX];
+    bool first = true;
+    char line[48];
+    int stdin_flags = fcntl(fileno(stdin), F_GETFL);
+    fcntl(fileno(stdin), F_SETFL, stdin_flags | O_NONBLOCK);
+
+    do {
+        for (int ch = 0; ch < CH_MAX; ch++) {
+            int val = adc_filtered[ch];
+            uint32_t freq = adc_freq_mhz[ch];
+            if (!first && val == last_val[ch] && freq == last_freq[ch]) continue;
+            last_val[ch] = val;
+            last_freq[ch] = freq;
+
+            char *p = watch_put(line, watch_prefix[ch], strlen(watch_prefix[ch]));
+            p = watch_put_int(p, val);
+            p = watch_put(p, watch_freq, sizeof(watch_freq) - 1);
+            p = watch_put_int(p, (int32_t)freq);
+            p = watch_put(p, watch_mhz, sizeof(watch_mhz) - 1);
+            pipeline_write(line, p - line);
+        }
+        first = false;
+        /* The refresh wait doubles as the keypress poll */
+    } while (!watch_wait_key(period_ms));
+
+    fcntl(fileno(stdin), F_SETFL, stdin_flags);
+
+    cli_printf("Watch stopped\n");
+    return 0;
+}
+
+/**
+ * @brief Task profiler command handler
+ *
+ * Takes two FreeRTOS runtime snapshots a window apart and prints each task's
+ * share of total CPU time (all cores) in that window, its minimum free stack
+ * and the pipeline queue depths.
+ */
+static int cmd_top(int argc, char **argv) {
+    int nerrors = arg_parse(argc, argv, (void *)&top_args);
+
+    if (nerrors != 0) {
+        cli_print_arg_errors(top_args.end, argv[0]);
+        return 1;
+    }
+
+#if configUSE_TRACE_FACILITY && configGENERATE_RUN_TIME_STATS
+    int window_ms = (top_args.window->count > 0) ? top_args.window->ival[0] : TOP_DEFAULT_MS;
+    if (window_ms < TOP_MIN_MS || window_ms > TOP_MAX_MS) {
+        cli_printf("Error: Window must be %d-%d ms\n", TOP_MIN_MS, TOP_MAX_MS);
+        return 1;
+    }
+
+    /* Slack covers tasks created between sizing and snapshot */
+    UBaseType_t cap = uxTaskGetNumberOfTasks() + TOP_TASK_SLACK;
+    TaskStatus_t *before = malloc(cap * sizeof(TaskStatus_t));
+    TaskStatus_t *after = malloc(cap * sizeof(TaskStatus_t));
+    if (before == NULL || after == NULL) {
+        free(before);
+        free(after);
+        cli_printf("Error: Out of memory\n");
+        return 1;
+    }
+
+    uint32_t total_before, total_after;
+    UBaseType_t n_before = uxTaskGetSystemState(before, cap, &total_before);
+    vTaskDelay(pdMS_TO_TICKS(window_ms));
+    UBaseType_t n_after = uxTaskGetSystemState(after, cap, &total_after);
+
+    uint64_t total = (uint64_t)(total_after - total_before) * portNUM_PROCESSORS;
+    if (n_before == 0 || n_after == 0 || total == 0) {
+        free(before);
+        free(after);
+        cli_printf("Error: Task snapshot failed\n");
+        return 1;
+    }
+
+    cli_printf("Window %d ms, %u tasks\n", window_ms, (unsigned)n_after);
+    cli_printf("%-16s %4s %5s %8s %12s\n", "Task", "Prio", "CPU%", "Stack", "Runtime");
+    for (UBaseType_t i = 0; i < n_after; i++) {
+        /* A task created during the window counts from zero */
+        uint32_t start = 0;
+        for (UBaseType_t j = 0; j < n_before; j++) {
+            if (before[j].xHandle == after[i].xHandle) {
+                start = before[j].ulRunTimeCounter;
+                break;
+            }
+        }
+        uint32_t delta = after[i].ulRunTimeCounter - start;
+        uint32_t permille = (uint32_t)((uint64_t)delta * 1000 / total);
+        cli_printf("%-16s %4u %3lu.%lu %8lu %12lu\n", after[i].pcTaskName,
+                   (unsigned)after[i].uxCurrentPriority,
+                   (unsigned long)(permille / 10), (unsigned long)(permille % 10),
+                   (unsigned long)after[i].usStackHighWaterMark, (unsigned long)delta);
+    }
+
+    free(before);
+    free(after);
+
+    cli_printf("Stack: minimum free bytes since task start\n");
+    cli_printf("Config queue: %lu/%d messages\n", (unsigned long)pipeline_cfg_pending(),
+               PIPELINE_CFG_QUEUE_LEN);
+    cli_printf("Output buffer: %lu/%d bytes, %lu dropped\n", (unsigned long)pipeline_out_pending(),
+               PIPELINE_OUT_BUF_SIZE, (unsigned long)pipeline_out_dropped());
+    return 0;
+#else
+    cli_printf("Error: Enable CONFIG_FREERTOS_USE_TRACE_FACILITY and "
+               "CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS\n");
+    return 1;
+#endif
+}
+
+/**
+ * @brief Register spectrum command
+ */
+static void register_fft_command(void) {
+    fft_args.channel = arg_int1("c", "channel", "<n>", "Channel number (0-5)");
+    fft_args.size = arg_int0("n", "size", "<n>", "FFT size, power of two (64-512)");
+    fft_args.rect = arg_lit0("r", "rect", "Rectangular window (default Hann)");
+    fft_args.end = arg_end(5);
+
+    esp_console_cmd_t cmd = {
+        .command = "fft",
+        .help = "Show power spectrum of recent samples",
+        .hint = NULL,
+        .func = &cmd_fft,
+        .argtable = &fft_args
+    };
+
+    esp_console_cmd_register(&cmd);
+}
+
+/**
+ * @brief Register tone detection command
+ */
+static void register_tone_command(void) {
+    tone_args.channel = arg_int0("c", "channel", "<n>", "Channel number (0-5)");
+    tone_args.freq = arg_dbln("f", "freq", "<Hz>", 0, GOERTZEL_MAX_TONES, "Add target tone frequency");
+    tone_args.clear = arg_lit0("x", "clear", "Clear channel tones");
+    tone_args.block = arg_int0("n", "block", "<n>", "Block length in samples (16-1024)");
+    tone_args.end = arg_end(5);
+
+    esp_console_cmd_t cmd = {
+        .command = "tone",
+        .help = "Configure and show Goertzel tone detection",
+        .hint = NULL,
+        .func = &cmd_tone,
+        .argtable = &tone_args
+    };
+
+    esp_console_cmd_register(&cmd);
+}
+
+/**
+ * @brief Register acquisition mode command
+ */
+static void register_power_command(void) {
+    power_args.continuous = arg_lit0("C", "continuous", "Continuous sampling every 200 ms");
+    power_args.interval = arg_int0("i", "interval", "<ms>", "Low-power wake interval (1000-3600000)");
+    power_args.burst = arg_int0("b", "burst", "<n>", "Low-power samples per wake (1-64)");
+    power_args.reset = arg_lit0("r", "reset", "Reset wake counters");
+    power_args.end = arg_end(5);
+
+    esp_console_cmd_t cmd = {
+        .command = "power",
+        .help = "Configure low-power acquisition and show wake statistics",
+        .hint = NULL,
+        .func = &cmd_power,
+        .argtable = &power_args
+    };
+
+    esp_console_cmd_register(&cmd);
+}
+
+/**
+ * @brief Register classifier command
+ */
+static void register_classify_command(void) {
+    classify_args.reset = arg_lit0("r", "reset", "Reset inference statistics");
+    classify_args.end = arg_end(2);
+
+    esp_console_cmd_t cmd = {
+        .command = "classify",
+        .help = "Show the latest classification and inference statistics",
+        .hint = NULL,
+        .func = &cmd_classify,
+        .argtable = &classify_args
+    };
+
+    esp_console_cmd_register(&cmd);
+}
+
+/**
+ * @brief Register feature vector command
+ */
+static void register_feat_command(void) {
+    feat_args.size = arg_int0("n", "size", "<n>", "Window, power of two (64-256, default 256)");
+    feat_args.end = arg_end(2);
+
+    esp_console_cmd_t cmd = {
+        .command = "feat",
+        .help = "Extract the int8 feature vector from the latest window",
+        .hint = NULL,
+        .func = &cmd_feat,
+        .argtable = &feat_args
+    };
+
+    esp_console_cmd_register(&cmd);
+}
+
+/**
+ * @brief Register live view command
+ */
+static void register_watch_command(void) {
+    watch_args.rate = arg_int0("r", "rate", "<ms>", "Refresh period (50-10000, default 500)");
+    watch_args.end = arg_end(2);
+
+    esp_console_cmd_t cmd = {
+        .command = "watch",
+        .help = "Stream changed channel values until a key is pressed",
+        .hint = NULL,
+        .func = &cmd_watch,
+        .argtable = &watch_args
+    };
+
+    esp_console_cmd_register(&cmd);
+}
+
+/**
+ * @brief Register task profiler command
+ */
+static void register_top_command(void) {
+    top_args.window = arg_int0("w", "window", "<ms>", "Sampling window (100-10000, default 1000)");
+    top_args.end = arg_end(2);
+
+    esp_console_cmd_t cmd = {
+        .command = "top",
+        .help = "Show per-task CPU share, stack headroom and pipeline queue depths",
+        .hint = NULL,
+        .func = &cmd_top,
+        .argtable = &top_args
+    };
+
+    esp_console_cmd_register(&cmd);
+}
+
+/**
+ * @brief Register benchmark command
+ */
+static void register_bench_command(void) {
+    bench_args.target = arg_str1(NULL, NULL, "<target>",
+                                 "fft, goertzel, power, nvs, jitter, adc, nn (all kernels), "
+                                 "conv, dwconv, fc, softmax, maxpool, avgpool, stream");
+    bench_args.width = arg_int0("W", "width", "<n>", "Input width");
+    bench_args.height = arg_int0("H", "height", "<n>", "Input height (softmax: rows)");
+    bench_args.in_ch = arg_int0("C", "in-ch", "<n>", "Input channels (fc: row length)");
+    bench_args.out_ch = arg_int0("O", "out-ch", "<n>", "Output channels");
+    bench_args.filter = arg_int0("k", "filter", "<n>", "Square filter size");
+    bench_args.stride = arg_int0("s", "stride", "<n>", "Stride");
+    bench_args.pad = arg_lit0("p", "pad", "SAME padding");
+    bench_args.end = arg_end(8);
+
+    esp_console_cmd_t cmd = {
+        .command = "bench",
+        .help = "Run performance benchmarks",
+        .hint = NULL,
+        .func = &cmd_bench,
+        .argtable = &bench_args
+    };
+
+    esp_console_cmd_register(&cmd);
+}
+
 /**
  * @brief Initialize and start CLI
+ *
+ * Returns once the REPL task is running.
  */
 void cli_init(void)
 {
@@ -221,7 +1566,8 @@ void cli_init(void)
     esp_console_repl_t *repl = NULL;
     esp_console_repl_config_t repl_config = ESP_CONSOLE_REPL_CONFIG_DEFAULT();
     repl_config.prompt = "CMD> ";
-    repl_config.max_cmdline_length = 256;
+    repl_config.max_cmdline_length = CONFIG_BLOB_MAX + 32;
+    repl_config.task_priority = CLI_TASK_PRIORITY;
 
     // Initialize UART for console
     esp_console_dev_uart_config_t hw_config = ESP_CONSOLE_DEV_UART_CONFIG_DEFAULT();
@@ -229,9 +1575,17 @@ void cli_init(void)
 
     // Register commands
     register_config_command();
+    register_fft_command();
+    register_tone_command();
+    register_power_command();
+    register_classify_command();
+    register_feat_command();
+    register_watch_command();
+    register_bench_command();
+    register_top_command();
     
     ESP_LOGI("CLI", "Starting REPL");
     
-    // Start the REPL (this blocks)
+    // Start the REPL in its own low-priority task
     ESP_ERROR_CHECK(esp_console_start_repl(repl));
 }
\ No newline at end of file
@@ -3,6 +3,6 @@
 #include "adc.h"
 
 /**
- * @brief CLI FreeRTOS task
+ * @brief Start the CLI REPL task (non-blocking)
  */
 void cli_init(void);
\ No newline at end of file
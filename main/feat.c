@@ -0,0 +1,118 @@
+#include "feat.h"
+#include "fft.h"
+#include "zcross.h"
+
+static const char *const feat_names[FEAT_PER_CH] = {
+    [FEAT_RMS] = "rms",
+    [FEAT_P2P] = "p2p",
+    [FEAT_ZCR] = "zcr",
+    [FEAT_SLOPE] = "slope",
+    [FEAT_BAND0] = "band0",
+    [FEAT_BAND0 + 1] = "band1",
+    [FEAT_BAND0 + 2] = "band2",
+    [FEAT_BAND0 + 3] = "band3",
+};
+_Static_assert(FEAT_BANDS == 4, "feat_names must list every band");
+
+static int16_t feat_samples[FEAT_MAX_WINDOW];
+static int16_t feat_work[FEAT_MAX_WINDOW];
+static uint32_t feat_power[FEAT_MAX_WINDOW / 2 + 1];
+
+const char *feat_name(int idx) {
+    return (idx >= 0 && idx < FEAT_PER_CH) ? feat_names[idx] : "?";
+}
+
+static inline int8_t clamp8(int32_t v) {
+    return v < -128 ? -128 : (v > 127 ? 127 : (int8_t)v);
+}
+
+static uint32_t isqrt64(uint64_t v) {
+    uint64_t r = 0;
+    uint64_t bit = 1ULL << 62;
+    while(bit > v) bit >>= 2;
+    while(bit) {
+        if(v >= r + bit) {
+            v -= r + bit;
+            r = (r >> 1) + bit;
+        } else {
+            r >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint32_t)r;
+}
+
+/**
+ * @brief log2 in 1/8 octave steps: 8 * integer part plus 3 mantissa bits
+ */
+static int32_t log2_q3(uint64_t v) {
+    if(v == 0) return 0;
+    int msb = 63 - __builtin_clzll(v);
+    uint32_t frac = msb >= 3 ? (uint32_t)(v >> (msb - 3)) & 7 : (uint32_t)(v << (3 - msb)) & 7;
+    return msb * 8 + frac;
+}
+
+int feat_compute(const int16_t *x, int n, int8_t *out) {
+    if(!fft_size_valid(n) || n > FEAT_MAX_WINDOW) return -1;
+
+    /* Time-domain sums in one pass */
+    int32_t sum = 0;
+    int64_t sum_ix = 0;
+    int16_t lo = x[0], hi = x[0];
+    for(int i=0; i<n; i++) {
+        sum += x[i];
+        sum_ix += (int64_t)i * x[i];
+        if(x[i] < lo) lo = x[i];
+        if(x[i] > hi) hi = x[i];
+    }
+    int32_t mean = sum / n;
+
+    uint64_t sq = 0;
+    int crossings = 0;
+    int above = x[0] > mean;
+    for(int i=0; i<n; i++) {
+        int32_t d = x[i] - mean;
+        sq += (uint64_t)((int64_t)d * d);
+        /* Same hysteresis band as the zero-crossing detector */
+        if(above && d < -ZC_HYST) {
+            above = 0;
+            crossings++;
+        } else if(!above && d > ZC_HYST) {
+            above = 1;
+            crossings++;
+        }
+    }
+
+    /* Least squares: slope = (n*Sxy - Sx*Sy) / (n*Sxx - Sx^2), scaled by n */
+    int64_t sx = (int64_t)n * (n - 1) / 2;
+    int64_t sxx = (int64_t)(n - 1) * n * (2 * n - 1) / 6;
+    int64_t num = (int64_t)n * sum_ix - sx * sum;
+    int64_t den = (int64_t)n * sxx - sx * sx;
+    int64_t change = num * n / den;
+
+    out[FEAT_RMS] = clamp8((int32_t)(isqrt64(sq / n) >> 4) - 128);
+    out[FEAT_P2P] = clamp8(((hi - lo) >> 4) - 128);
+    out[FEAT_ZCR] = clamp8(crossings * 256 / n - 128);
+    out[FEAT_SLOPE] = clamp8((int32_t)(change / 32));
+
+    /* Octave bands over bins 1..n/2; DC is removed by the spectrum */
+    fft_power_spectrum(x, n, FFT_WINDOW_HANN, feat_work, feat_power);
+    int hi_bin = n / 2;
+    for(int b=FEAT_BANDS-1; b>=0; b--) {
+        int lo_bin = (b == 0) ? 1 : hi_bin / 2;
+        uint64_t e = 0;
+        for(int k=lo_bin; k<=hi_bin; k++) e += feat_power[k];
+        out[FEAT_BAND0 + b] = clamp8(log2_q3(e) - 128);
+        hi_bin = lo_bin - 1;
+    }
+    return FEAT_PER_CH;
+}
+
+int feat_frame(int n, int8_t *dst) {
+    if(!fft_size_valid(n) || n > FEAT_MAX_WINDOW) return -1;
+    for(int ch=0; ch<CH_MAX; ch++) {
+        if(adc_read_block(ch, feat_samples, n) < 0) return -1;
+        feat_compute(feat_samples, n, dst + ch * FEAT_PER_CH);
+    }
+    return FEAT_LEN;
+}
@@ -0,0 +1,64 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include "adc.h"
+
+/**
+ * @brief Octave bands of the spectrum, highest band ending at Nyquist
+ */
+#define FEAT_BANDS 4
+
+/**
+ * @brief Largest window for feature extraction (samples, power of two)
+ */
+#define FEAT_MAX_WINDOW 256
+
+/**
+ * @brief Feature layout within one channel's block of the vector
+ */
+typedef enum {
+    FEAT_RMS = 0,       /* AC RMS, 16 counts per code */
+    FEAT_P2P,           /* peak-to-peak, 16 counts per code */
+    FEAT_ZCR,           /* mean crossings per 256 samples */
+    FEAT_SLOPE,         /* least-squares change over the window, 32 counts per code, signed */
+    FEAT_BAND0,         /* band energies, 1/8 octave (log2) per code */
+    FEAT_PER_CH = FEAT_BAND0 + FEAT_BANDS
+} feat_index_t;
+
+/**
+ * @brief Length of a full frame vector, channel-major
+ */
+#define FEAT_LEN (CH_MAX * FEAT_PER_CH)
+
+/**
+ * @brief input_offset to pass to esp_nn_fully_connected_s8 for a frame
+ *
+ * Unsigned features are coded from -128 up and the slope is signed, so the
+ * codes are used as-is.
+ */
+#define FEAT_INPUT_OFFSET 0
+
+/**
+ * @brief Name of a feature within a channel block
+ */
+const char *feat_name(int idx);
+
+/**
+ * @brief Extract one channel's features from a window
+ * @param x n raw ADC samples
+ * @param n Window length, power of two from FFT_MIN_N to FEAT_MAX_WINDOW
+ * @param out FEAT_PER_CH feature codes
+ * @return FEAT_PER_CH on success, -1 on invalid length
+ */
+int feat_compute(const int16_t *x, int n, int8_t *out);
+
+/**
+ * @brief Extract all channels from the latest ADC window
+ *
+ * Uses module buffers, so only one task may call it at a time.
+ *
+ * @param n Window length, as for feat_compute()
+ * @param dst FEAT_LEN feature codes, channel-major, ready as an FC input
+ * @return FEAT_LEN on success, -1 if invalid or not enough samples acquired yet
+ */
+int feat_frame(int n, int8_t *dst);
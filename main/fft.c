@@ -0,0 +1,171 @@
+#include "fft.h"
+
+/* Quarter-wave sine table, Q15, sin(pi/2 * i / 256) for i = 0..256.
+ * Resolves the full circle in FFT_MAX_N steps. Lives in flash (.rodata). */
+static const int16_t sin_quarter_q15[257] = {
+        0,   201,   402,   603,   804,  1005,  1206,  1407,  1608,  1809,  2009,  2210,
+     2411,  2611,  2811,  3012,  3212,  3412,  3612,  3812,  4011,  4211,  4410,  4609,
+     4808,  5007,  5205,  5404,  5602,  5800,  5998,  6195,  6393,  6590,  6787,  6983,
+     7180,  7376,  7571,  7767,  7962,  8157,  8351,  8546,  8740,  8933,  9127,  9319,
+     9512,  9704,  9896, 10088, 10279, 10469, 10660, 10850, 11039, 11228, 11417, 11605,
+    11793, 11980, 12167, 12354, 12540, 12725, 12910, 13095, 13279, 13463, 13646, 13828,
+    14010, 14192, 14373, 14553, 14733, 14912, 15091, 15269, 15447, 15624, 15800, 15976,
+    16151, 16326, 16500, 16673, 16846, 17018, 17190, 17361, 17531, 17700, 17869, 18037,
+    18205, 18372, 18538, 18703, 18868, 19032, 19195, 19358, 19520, 19681, 19841, 20001,
+    20160, 20318, 20475, 20632, 20788, 20943, 21097, 21251, 21403, 21555, 21706, 21856,
+    22006, 22154, 22302, 22449, 22595, 22740, 22884, 23028, 23170, 23312, 23453, 23593,
+    23732, 23870, 24008, 24144, 24279, 24414, 24548, 24680, 24812, 24943, 25073, 25202,
+    25330, 25457, 25583, 25708, 25833, 25956, 26078, 26199, 26320, 26439, 26557, 26674,
+    26791, 26906, 27020, 27133, 27246, 27357, 27467, 27576, 27684, 27791, 27897, 28002,
+    28106, 28209, 28311, 28411, 28511, 28610, 28707, 28803, 28899, 28993, 29086, 29178,
+    29269, 29359, 29448, 29535, 29622, 29707, 29792, 29875, 29957, 30038, 30118, 30196,
+    30274, 30350, 30425, 30499, 30572, 30644, 30715, 30784, 30853, 30920, 30986, 31050,
+    31114, 31177, 31238, 31298, 31357, 31415, 31471, 31527, 31581, 31634, 31686, 31737,
+    31786, 31834, 31881, 31927, 31972, 32015, 32058, 32099, 32138, 32177, 32214, 32251,
+    32286, 32319, 32352, 32383, 32413, 32442, 32470, 32496, 32522, 32546, 32568, 32590,
+    32610, 32629, 32647, 32664, 32679, 32693, 32706, 32718, 32729, 32738, 32746, 32753,
+    32758, 32762, 32766, 32767, 32767,
+};
+
+/**
+ * @brief Sine of 2*pi*i/FFT_MAX_N in Q15
+ */
+static inline int32_t sin_q15(int i)
+{
+    i &= FFT_MAX_N - 1;
+    int r = i & 255;
+    switch (i >> 8) {
+    case 0:  return sin_quarter_q15[r];
+    case 1:  return sin_quarter_q15[256 - r];
+    case 2:  return -sin_quarter_q15[r];
+    default: return -sin_quarter_q15[256 - r];
+    }
+}
+
+/**
+ * @brief Cosine of 2*pi*i/FFT_MAX_N in Q15
+ */
+static inline int32_t cos_q15(int i)
+{
+    return sin_q15(i + FFT_MAX_N / 4);
+}
+
+bool fft_size_valid(int n)
+{
+    return n >= FFT_MIN_N && n <= FFT_MAX_N && (n & (n - 1)) == 0;
+}
+
+/**
+ * @brief In-place radix-2 DIT complex FFT on m interleaved Q15 values,
+ *        scaled by 1/2 per stage
+ */
+static void fft_complex_q15(int16_t *z, int m)
+{
+    /* Bit-reversal permutation */
+    for (int i = 1, j = 0; i < m; i++) {
+        int bit = m >> 1;
+        for (; j & bit; bit >>= 1) {
+            j ^= bit;
+        }
+        j |= bit;
+        if (i < j) {
+            int16_t tr = z[2 * i], ti = z[2 * i + 1];
+            z[2 * i] = z[2 * j];
+            z[2 * i + 1] = z[2 * j + 1];
+            z[2 * j] = tr;
+            z[2 * j + 1] = ti;
+        }
+    }
+
+    for (int len = 2; len <= m; len <<= 1) {
+        int half = len >> 1;
+        int step = FFT_MAX_N / len;
+        for (int k = 0; k < half; k++) {
+            /* W = exp(-2*pi*i*k/len) */
+            int32_t wr = cos_q15(k * step);
+            int32_t wi = -sin_q15(k * step);
+            for (int base = 0; base < m; base += len) {
+                int16_t *u = &z[2 * (base + k)];
+                int16_t *v = &z[2 * (base + k + half)];
+                int32_t vr = (v[0] * wr - v[1] * wi) >> 15;
+                int32_t vi = (v[0] * wi + v[1] * wr) >> 15;
+                int32_t ur = u[0], ui = u[1];
+                u[0] = (ur + vr) >> 1;
+                u[1] = (ui + vi) >> 1;
+                v[0] = (ur - vr) >> 1;
+                v[1] = (ui - vi) >> 1;
+            }
+        }
+    }
+}
+
+int fft_real_q15(int16_t *data, int n)
+{
+    if (!fft_size_valid(n)) return -1;
+
+    int m = n / 2;
+    fft_complex_q15(data, m);
+
+    /* Split Z = FFT(even + i*odd) into X[k], k = 0..m, scaled by 1/2 */
+    int32_t zr = data[0], zi = data[1];
+    data[0] = (zr + zi) >> 1;
+    data[1] = (zr - zi) >> 1;
+
+    int step = FFT_MAX_N / n;
+    for (int k = 1; k <= m / 2; k++) {
+        int16_t *pa = &data[2 * k];
+        int16_t *pb = &data[2 * (m - k)];
+        int32_t ar = pa[0], ai = pa[1];
+        int32_t br = pb[0], bi = -pb[1];
+
+        int32_t er = ar + br, ei = ai + bi;
+        int32_t dr = ar - br, di = ai - bi;
+
+        /* t = W^k * (-i) * d with W = exp(-2*pi*i*k/n) */
+        int32_t c = cos_q15(k * step);
+        int32_t s = sin_q15(k * step);
+        int32_t tr = (c * di - s * dr) >> 15;
+        int32_t ti = (-c * dr - s * di) >> 15;
+
+        /* X[k] = (e + t) / 2, X[m-k] = conj(e - t) / 2, both scaled by 1/2 */
+        pa[0] = (er + tr) >> 2;
+        pa[1] = (ei + ti) >> 2;
+        pb[0] = (er - tr) >> 2;
+        pb[1] = -((ei - ti) >> 2);
+    }
+    return 0;
+}
+
+int fft_power_spectrum(const int16_t *samples, int n, fft_window_t win,
+                       int16_t *work, uint32_t *power)
+{
+    if (!fft_size_valid(n)) return -1;
+
+    int32_t sum = 0;
+    for (int i = 0; i < n; i++) {
+        sum += samples[i];
+    }
+    int32_t mean = sum / n;
+
+    /* 12-bit samples minus mean fit in Q15 after a 3-bit shift */
+    int step = FFT_MAX_N / n;
+    for (int i = 0; i < n; i++) {
+        int32_t x = (samples[i] - mean) << 3;
+        if (win == FFT_WINDOW_HANN) {
+            int32_t w = (32767 - cos_q15(i * step)) >> 1;
+            x = (x * w) >> 15;
+        }
+        work[i] = (int16_t)x;
+    }
+
+    fft_real_q15(work, n);
+
+    int m = n / 2;
+    power[0] = (uint32_t)(work[0] * work[0]);
+    power[m] = (uint32_t)(work[1] * work[1]);
+    for (int k = 1; k < m; k++) {
+        int32_t re = work[2 * k], im = work[2 * k + 1];
+        power[k] = (uint32_t)(re * re) + (uint32_t)(im * im);
+    }
+    return 0;
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Smallest supported FFT size
+ */
+#define FFT_MIN_N 64
+
+/**
+ * @brief Largest supported FFT size (also the twiddle table resolution)
+ */
+#define FFT_MAX_N 1024
+
+/**
+ * @brief Window applied to a block before the transform
+ */
+typedef enum {
+    FFT_WINDOW_RECT = 0,
+    FFT_WINDOW_HANN
+} fft_window_t;
+
+/**
+ * @brief Check that n is a power of two in [FFT_MIN_N, FFT_MAX_N]
+ */
+bool fft_size_valid(int n);
+
+/**
+ * @brief In-place fixed-point real FFT (Q15)
+ *
+ * The n real samples are transformed as an n/2-point complex FFT followed
+ * by a split step. Every stage scales by 1/2, so the result is X[k] / n.
+ * Output packing: data[0] = Re X[0], data[1] = Re X[n/2],
+ * data[2k] = Re X[k], data[2k+1] = Im X[k] for 0 < k < n/2.
+ *
+ * @param data n samples in, n packed spectrum values out
+ * @param n Transform size, see fft_size_valid()
+ * @return 0 on success, -1 on invalid size
+ */
+int fft_real_q15(int16_t *data, int n);
+
+/**
+ * @brief Power spectrum of a block of raw ADC samples
+ *
+ * Removes the block mean, applies the window and runs fft_real_q15().
+ *
+ * @param samples n raw ADC samples (0-4095)
+ * @param n Transform size
+ * @param win Window to apply
+ * @param work Scratch buffer of n int16_t
+ * @param power Output, n/2 + 1 bins of |X[k]|^2
+ * @return 0 on success, -1 on invalid size
+ */
+int fft_power_spectrum(const int16_t *samples, int n, fft_window_t win,
+                       int16_t *work, uint32_t *power);
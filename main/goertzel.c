@@ -0,0 +1,135 @@
+#include "goertzel.h"
+#include "adc.h"
+#include <math.h>
+#include "freertos/FreeRTOS.h"
+
+static goertzel_bank_t banks[CH_MAX];
+static volatile int block_len = GOERTZEL_DEFAULT_BLOCK;
+/* Channel banks are changed by the console side while adc_task, possibly on
+ * the other core, runs them */
+static portMUX_TYPE bank_lock = portMUX_INITIALIZER_UNLOCKED;
+
+bool goertzel_tone_valid(uint32_t freq_mhz) {
+    return freq_mhz > 0 && freq_mhz < ADC_SAMPLE_RATE_MHZ / 2;
+}
+
+/**
+ * @brief Drop the block in progress
+ *
+ * A tone joining mid-block would see only part of it while its power is
+ * still normalised by the full length, so every tone starts over.
+ */
+static void goertzel_bank_restart(goertzel_bank_t *bank) {
+    for(int i=0; i<bank->count; i++) {
+        bank->tones[i].s1 = 0;
+        bank->tones[i].s2 = 0;
+    }
+    bank->pos = 0;
+}
+
+int goertzel_bank_add_tone(goertzel_bank_t *bank, uint32_t freq_mhz) {
+    if(!goertzel_tone_valid(freq_mhz)) return -1;
+
+    int idx = bank->count;
+    if(idx >= GOERTZEL_MAX_TONES) return -1;
+
+    goertzel_tone_t *t = &bank->tones[idx];
+    double w = 2.0 * M_PI * (double)freq_mhz / (double)ADC_SAMPLE_RATE_MHZ;
+    t->freq_mhz = freq_mhz;
+    t->coeff_q14 = (int32_t)lround(2.0 * cos(w) * (1 << 14));
+    t->power = 0;
+
+    bank->count = idx + 1;
+    goertzel_bank_restart(bank);
+    return idx;
+}
+
+void goertzel_bank_clear(goertzel_bank_t *bank) {
+    bank->count = 0;
+    bank->pos = 0;
+}
+
+void goertzel_bank_update(goertzel_bank_t *bank, int16_t sample, int len) {
+    int count = bank->count;
+    if(count == 0) return;
+
+    /* Centre the 12-bit sample to keep the resonator away from DC overflow */
+    int32_t x = sample - 2048;
+    for(int i=0; i<count; i++) {
+        goertzel_tone_t *t = &bank->tones[i];
+        int32_t s0 = x + (int32_t)(((int64_t)t->coeff_q14 * t->s1) >> 14) - t->s2;
+        t->s2 = t->s1;
+        t->s1 = s0;
+    }
+
+    if(++bank->pos < len) return;
+
+    /* |X|^2 = s1^2 + s2^2 - coeff*s1*s2, normalised by (N/2)^2 */
+    int64_t n = bank->pos;
+    int64_t norm = (n * n) / 4;
+    for(int i=0; i<count; i++) {
+        goertzel_tone_t *t = &bank->tones[i];
+        int64_t s1 = t->s1, s2 = t->s2;
+        int64_t p = s1 * s1 + s2 * s2 - ((t->coeff_q14 * s1 * s2) >> 14);
+        if(p < 0) p = 0;
+        p /= norm;
+        t->power = p > UINT32_MAX ? UINT32_MAX : (uint32_t)p;
+        t->s1 = 0;
+        t->s2 = 0;
+    }
+    bank->pos = 0;
+}
+
+bool goertzel_set_tones(int ch, const uint32_t *freq_mhz, int n) {
+    if(!check_channel(ch) || n < 0 || n > GOERTZEL_MAX_TONES) return false;
+
+    /* Coefficients are worked out before taking the lock */
+    goertzel_bank_t bank = { 0 };
+    for(int i=0; i<n; i++) {
+        if(goertzel_bank_add_tone(&bank, freq_mhz[i]) < 0) return false;
+    }
+
+    portENTER_CRITICAL(&bank_lock);
+    banks[ch] = bank;
+    portEXIT_CRITICAL(&bank_lock);
+    return true;
+}
+
+bool goertzel_set_block_len(int n) {
+    if(n < GOERTZEL_MIN_BLOCK || n > GOERTZEL_MAX_BLOCK) return false;
+    block_len = n;
+    return true;
+}
+
+int goertzel_get_block_len(void) {
+    return block_len;
+}
+
+void goertzel_update(int ch, int16_t sample) {
+    portENTER_CRITICAL(&bank_lock);
+    goertzel_bank_update(&banks[ch], sample, block_len);
+    portEXIT_CRITICAL(&bank_lock);
+}
+
+int goertzel_tone_count(int ch) {
+    if(!check_channel(ch)) return 0;
+    return banks[ch].count;
+}
+
+uint32_t goertzel_tone_freq(int ch, int tone) {
+    uint32_t freq = 0;
+    if(!check_channel(ch)) return 0;
+    portENTER_CRITICAL(&bank_lock);
+    if(tone >= 0 && tone < banks[ch].count) freq = banks[ch].tones[tone].freq_mhz;
+    portEXIT_CRITICAL(&bank_lock);
+    return freq;
+}
+
+uint32_t goertzel_tone_power(int ch, int tone) {
+    uint32_t power = 0;
+    if(!check_channel(ch)) return 0;
+    portENTER_CRITICAL(&bank_lock);
+    if(tone >= 0 && tone < banks[ch].count) power = banks[ch].tones[tone].power;
+    portEXIT_CRITICAL(&bank_lock);
+    return power;
+}
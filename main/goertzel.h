@@ -0,0 +1,120 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Maximum number of target tones per channel
+ */
+#define GOERTZEL_MAX_TONES 8
+
+/**
+ * @brief Default block length in samples
+ */
+#define GOERTZEL_DEFAULT_BLOCK 128
+
+/**
+ * @brief Allowed block length range in samples
+ */
+#define GOERTZEL_MIN_BLOCK 16
+#define GOERTZEL_MAX_BLOCK 1024
+
+/**
+ * @brief One target tone of a bank
+ */
+typedef struct {
+    uint32_t freq_mhz;
+    int32_t coeff_q14;  /* 2*cos(2*pi*f/fs) in Q14 */
+    int32_t s1;
+    int32_t s2;
+    uint32_t power;
+} goertzel_tone_t;
+
+/**
+ * @brief Set of tones fed from one sample stream
+ *
+ * Each channel owns one bank, updated by adc_task. Callers that need a bank
+ * of their own (benchmarks, offline analysis) zero-initialise one and use the
+ * goertzel_bank_* functions, which never touch the channel banks.
+ */
+typedef struct {
+    goertzel_tone_t tones[GOERTZEL_MAX_TONES];
+    volatile int count;
+    int pos;
+} goertzel_bank_t;
+
+/**
+ * @brief Check that a tone frequency is above zero and below Nyquist
+ */
+bool goertzel_tone_valid(uint32_t freq_mhz);
+
+/**
+ * @brief Add a target tone to a bank
+ *
+ * Restarts the block in progress for every tone of the bank, so the first
+ * power reported after the change covers a full block.
+ *
+ * @return Tone index, or -1 if invalid or the bank is full
+ */
+int goertzel_bank_add_tone(goertzel_bank_t *bank, uint32_t freq_mhz);
+
+/**
+ * @brief Remove all tones from a bank
+ */
+void goertzel_bank_clear(goertzel_bank_t *bank);
+
+/**
+ * @brief Feed one raw sample (0-4095) to a bank
+ * @param len Block length in samples; tone powers are latched every len samples
+ */
+void goertzel_bank_update(goertzel_bank_t *bank, int16_t sample, int len);
+
+/**
+ * @brief Replace the tones of a channel's bank
+ *
+ * The new bank is built aside and swapped in under a lock, so adc_task
+ * never sees a half-configured bank. Its block starts over and previous
+ * powers are dropped.
+ *
+ * @param ch Channel index
+ * @param freq_mhz Tone frequencies in milli-hertz, below Nyquist
+ * @param n Number of tones, 0 to clear (at most GOERTZEL_MAX_TONES)
+ * @return false if any tone is invalid, nothing is changed then
+ */
+bool goertzel_set_tones(int ch, const uint32_t *freq_mhz, int n);
+
+/**
+ * @brief Set the block length used by every channel
+ * @return true if accepted, false if out of range
+ */
+bool goertzel_set_block_len(int n);
+
+/**
+ * @brief Current block length in samples
+ */
+int goertzel_get_block_len(void);
+
+/**
+ * @brief Feed one raw sample (0-4095) to a channel's bank
+ *
+ * Runs one fixed-point Goertzel iteration per configured tone. At the end
+ * of each block the tone powers are latched and the state is reset.
+ */
+void goertzel_update(int ch, int16_t sample);
+
+/**
+ * @brief Number of tones configured on a channel
+ */
+int goertzel_tone_count(int ch);
+
+/**
+ * @brief Frequency of a configured tone in milli-hertz
+ */
+uint32_t goertzel_tone_freq(int ch, int tone);
+
+/**
+ * @brief Power of a tone over the last complete block
+ *
+ * Normalised to squared amplitude in ADC counts: a full-block sine of
+ * amplitude A at the tone frequency reports about A*A.
+ */
+uint32_t goertzel_tone_power(int ch, int tone);
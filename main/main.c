@@ -11,20 +11,32 @@
 #include "adc.h"
 #include "cli.h"
 #include "nvs.h"
+#include "pipeline.h"
+#include "classifier.h"
+#include "nn_lock.h"
+#include "sdkconfig.h"
 
 /**
  * @brief Main application entry point.
  *
- * Initializes NVS, then starts the ADC and CLI FreeRTOS tasks.
+ * Initializes NVS and the pipeline queues, then starts the ADC, inference
+ * and CLI FreeRTOS tasks. The CLI runs below acquisition and only talks to it
+ * through the pipeline queues. Inference only starts with
+ * CONFIG_APP_CLASSIFIER, since the bundled model is a placeholder.
  */
 void app_main(void)
 {
     nvs_init();
-    xTaskCreate(adc_task, "adc_task", 4096, NULL, 5, NULL);
+    pipeline_init();
+    nn_lock_init();
+    xTaskCreate(adc_task, "adc_task", 4096, NULL, ADC_TASK_PRIORITY, NULL);
+#ifdef CONFIG_APP_CLASSIFIER
+    classifier_init(&cls_default_model);
+#endif
     
     // Give ADC task time to initialize before starting CLI
     vTaskDelay(pdMS_TO_TICKS(100));
     
-    cli_init();  // This will block and run the REPL
+    cli_init();  // Starts the REPL task and returns
 }
 
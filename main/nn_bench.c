@@ -0,0 +1,335 @@
+#include "nn_bench.h"
+#include <stdlib.h>
+#include <string.h>
+#include "esp_nn.h"
+#include "esp_cpu.h"
+#include "stream_conv.h"
+#include "nn_lock.h"
+
+static const char *const kernel_names[NN_BENCH_COUNT] = {
+    [NN_BENCH_CONV]    = "conv",
+    [NN_BENCH_DWCONV]  = "dwconv",
+    [NN_BENCH_FC]      = "fc",
+    [NN_BENCH_SOFTMAX] = "softmax",
+    [NN_BENCH_MAXPOOL] = "maxpool",
+    [NN_BENCH_AVGPOOL] = "avgpool",
+    [NN_BENCH_STREAM]  = "stream",
+};
+
+/* README reference cases */
+static const nn_bench_shape_t default_shapes[NN_BENCH_COUNT] = {
+    [NN_BENCH_CONV]    = { .width = 10, .height = 10, .in_ch = 3,   .out_ch = 64, .filter = 3, .stride = 1 },
+    [NN_BENCH_DWCONV]  = { .width = 16, .height = 16, .in_ch = 16,  .out_ch = 16, .filter = 3, .stride = 1 },
+    [NN_BENCH_FC]      = { .width = 1,  .height = 1,  .in_ch = 271, .out_ch = 3,  .filter = 1, .stride = 1 },
+    [NN_BENCH_SOFTMAX] = { .width = 1,  .height = 8,  .in_ch = 64,  .out_ch = 64, .filter = 1, .stride = 1 },
+    [NN_BENCH_MAXPOOL] = { .width = 16, .height = 16, .in_ch = 16,  .out_ch = 16, .filter = 3, .stride = 1 },
+    [NN_BENCH_AVGPOOL] = { .width = 16, .height = 16, .in_ch = 16,  .out_ch = 16, .filter = 3, .stride = 1 },
+    /* classifier conv layer over a 64-sample window */
+    [NN_BENCH_STREAM]  = { .width = 64, .height = 1,  .in_ch = 6,   .out_ch = 8,  .filter = 5, .stride = 1 },
+};
+
+const char *nn_bench_name(nn_bench_kernel_t kernel) {
+    return kernel < NN_BENCH_COUNT ? kernel_names[kernel] : "?";
+}
+
+nn_bench_kernel_t nn_bench_lookup(const char *name) {
+    for (int k = 0; k < NN_BENCH_COUNT; k++) {
+        if (strcmp(name, kernel_names[k]) == 0) return k;
+    }
+    return NN_BENCH_COUNT;
+}
+
+void nn_bench_default_shape(nn_bench_kernel_t kernel, nn_bench_shape_t *shape) {
+    *shape = default_shapes[kernel < NN_BENCH_COUNT ? kernel : NN_BENCH_CONV];
+}
+
+static void fill_random(int8_t *buf, int len) {
+    for (int i = 0; i < len; i++) {
+        buf[i] = rand() % 256 - 128;
+    }
+}
+
+/**
+ * @brief Output size along one axis, TFLite SAME (pad) or VALID rules
+ */
+static int out_dim(int in, int filter, int stride, int pad) {
+    return pad ? (in + stride - 1) / stride : (in - filter + stride) / stride;
+}
+
+/**
+ * @brief Full-window 1-D conv against a streaming step, see nn_bench_result_t
+ */
+static esp_err_t nn_bench_stream(const nn_bench_shape_t *s, nn_bench_result_t *r)
+{
+    int out_wd = out_dim(s->width, s->filter, s->stride, 0);
+    int in_size = s->width * s->in_ch;
+    int filter_size = s->filter * s->in_ch * s->out_ch;
+    int out_size = out_wd * s->out_ch;
+    r->ops = (uint64_t)filter_size;
+
+    int8_t *input = malloc(in_size);
+    int8_t *filter = malloc(filter_size);
+    int8_t *out_ansi = malloc(out_size);
+    int8_t *out_stream = malloc(out_size);
+    int32_t *bias = malloc(s->out_ch * sizeof(int32_t));
+    int32_t *shift = malloc(s->out_ch * sizeof(int32_t));
+    int32_t *mult = malloc(s->out_ch * sizeof(int32_t));
+    stream_conv_t sc = { 0 };
+    esp_err_t ret = ESP_ERR_NO_MEM;
+
+    if (!input || !filter || !out_ansi || !out_stream || !bias || !shift || !mult) {
+        goto cleanup;
+    }
+
+    fill_random(input, in_size);
+    fill_random(filter, filter_size);
+    for (int i = 0; i < s->out_ch; i++) {
+        bias[i] = rand() % UINT16_MAX;
+        shift[i] = -10 + rand() % 2;
+        mult[i] = 0x7f67f4f8 + rand() % 50;
+    }
+
+    data_dims_t in_dims = { .width = s->width, .height = 1, .channels = s->in_ch, .extra = 1 };
+    data_dims_t out_dims = { .width = out_wd, .height = 1, .channels = s->out_ch, .extra = 1 };
+    data_dims_t filter_dims = { .width = s->filter, .height = 1, .channels = s->in_ch, .extra = 1 };
+    quant_data_t quant = { .shift = shift, .mult = mult };
+    conv_params_t params = { .in_offset = 0, .out_offset = 0,
+                             .stride = { s->stride, 1 }, .padding = { 0, 0 },
+                             .dilation = { 1, 1 }, .activation = { -128, 127 } };
+
+    ret = stream_conv_init(&sc, s->in_ch, s->out_ch, s->filter, filter, bias, &params, &quant);
+    if (ret != ESP_OK) goto cleanup;
+
+    uint32_t start = esp_cpu_get_cycle_count();
+    esp_nn_conv_s8_ansi(&in_dims, input, &filter_dims, filter, bias, &out_dims, out_ansi, &params, &quant);
+    r->ansi_cycles = esp_cpu_get_cycle_count() - start;
+
+    /* Time the last producing step, all the others just fill history */
+    int8_t *out = out_stream;
+    for (int i = 0; i < s->width; i++) {
+        start = esp_cpu_get_cycle_count();
+        int produced = stream_conv_push(&sc, input + i * s->in_ch, out);
+        uint32_t cycles = esp_cpu_get_cycle_count() - start;
+        if (produced) {
+            r->opt_cycles = cycles;
+            out += s->out_ch;
+        }
+    }
+    r->exact = out == out_stream + out_size && memcmp(out_ansi, out_stream, out_size) == 0;
+
+cleanup:
+    stream_conv_free(&sc);
+    esp_nn_set_conv_scratch_buf(NULL);
+    free(input);
+    free(filter);
+    free(out_ansi);
+    free(out_stream);
+    free(bias);
+    free(shift);
+    free(mult);
+    return ret;
+}
+
+/**
+ * @brief One benchmark case, run with the esp-nn lock held
+ */
+static esp_err_t nn_bench_case(nn_bench_kernel_t kernel, const nn_bench_shape_t *s,
+                               nn_bench_result_t *r) {
+    if (kernel >= NN_BENCH_COUNT || s->width < 1 || s->height < 1 || s->in_ch < 1 ||
+        s->out_ch < 1 || s->filter < 1 || s->stride < 1 ||
+        s->filter > s->width || (kernel != NN_BENCH_STREAM && s->filter > s->height)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (kernel == NN_BENCH_STREAM) {
+        return nn_bench_stream(s, r);
+    }
+
+    int out_wd = out_dim(s->width, s->filter, s->stride, s->pad);
+    int out_ht = out_dim(s->height, s->filter, s->stride, s->pad);
+    int pad_wd = s->pad ? (((out_wd - 1) * s->stride + s->filter - s->width) / 2) : 0;
+    int pad_ht = s->pad ? (((out_ht - 1) * s->stride + s->filter - s->height) / 2) : 0;
+    if (pad_wd < 0) pad_wd = 0;
+    if (pad_ht < 0) pad_ht = 0;
+
+    int in_size = s->width * s->height * s->in_ch;
+    int out_ch = s->out_ch;
+    int filter_size = 0;
+    int out_size = 0;
+
+    switch (kernel) {
+    case NN_BENCH_CONV:
+        filter_size = s->filter * s->filter * s->in_ch * out_ch;
+        out_size = out_wd * out_ht * out_ch;
+        r->ops = (uint64_t)out_size * s->filter * s->filter * s->in_ch;
+        break;
+    case NN_BENCH_DWCONV:
+        /* out_ch must be a multiple of in_ch (channel multiplier) */
+        if (out_ch % s->in_ch) return ESP_ERR_INVALID_ARG;
+        filter_size = s->filter * s->filter * out_ch;
+        out_size = out_wd * out_ht * out_ch;
+        r->ops = (uint64_t)out_size * s->filter * s->filter;
+        break;
+    case NN_BENCH_FC:
+        in_size = s->in_ch;
+        filter_size = s->in_ch * out_ch;
+        out_size = out_ch;
+        r->ops = (uint64_t)filter_size;
+        break;
+    case NN_BENCH_SOFTMAX:
+        in_size = s->in_ch * s->height;
+        out_size = in_size;
+        r->ops = (uint64_t)in_size;
+        break;
+    default:
+        out_ch = s->in_ch;
+        out_size = out_wd * out_ht * out_ch;
+        r->ops = (uint64_t)out_size * s->filter * s->filter;
+        break;
+    }
+
+    int32_t n_ch = out_ch;
+    int8_t *input = malloc(in_size);
+    int8_t *filter = malloc(filter_size + 1);
+    int8_t *out_ansi = malloc(out_size);
+    int8_t *out_opt = malloc(out_size);
+    int32_t *bias = malloc(n_ch * sizeof(int32_t));
+    int32_t *shift = malloc(n_ch * sizeof(int32_t));
+    int32_t *mult = malloc(n_ch * sizeof(int32_t));
+    void *scratch = NULL;
+    esp_err_t ret = ESP_OK;
+
+    if (!input || !filter || !out_ansi || !out_opt || !bias || !shift || !mult) {
+        ret = ESP_ERR_NO_MEM;
+        goto cleanup;
+    }
+
+    fill_random(input, in_size);
+    fill_random(filter, filter_size);
+    for (int i = 0; i < n_ch; i++) {
+        bias[i] = rand() % UINT16_MAX;
+        shift[i] = -10 + rand() % 2;
+        mult[i] = 0x7f67f4f8 + rand() % 50;
+    }
+
+    data_dims_t in_dims = { .width = s->width, .height = s->height, .channels = s->in_ch, .extra = 1 };
+    data_dims_t out_dims = { .width = out_wd, .height = out_ht, .channels = out_ch, .extra = 1 };
+    data_dims_t filter_dims = { .width = s->filter, .height = s->filter, .channels = s->in_ch, .extra = 1 };
+    quant_data_t quant = { .shift = shift, .mult = mult };
+    uint32_t start;
+
+    switch (kernel) {
+    case NN_BENCH_CONV: {
+        conv_params_t params = { .in_offset = 0, .out_offset = 0,
+                                 .stride = { s->stride, s->stride }, .padding = { pad_wd, pad_ht },
+                                 .dilation = { 1, 1 }, .activation = { -128, 127 } };
+        int size = esp_nn_get_conv_scratch_size(&in_dims, &filter_dims, &out_dims, &params);
+        if (size > 0) {
+            scratch = malloc(size + 16);
+            if (!scratch) { ret = ESP_ERR_NO_MEM; goto cleanup; }
+            esp_nn_set_conv_scratch_buf((void *)(((uintptr_t)scratch + 15) & ~(uintptr_t)15));
+        }
+        start = esp_cpu_get_cycle_count();
+        esp_nn_conv_s8_ansi(&in_dims, input, &filter_dims, filter, bias, &out_dims, out_ansi, &params, &quant);
+        r->ansi_cycles = esp_cpu_get_cycle_count() - start;
+        start = esp_cpu_get_cycle_count();
+        esp_nn_conv_s8(&in_dims, input, &filter_dims, filter, bias, &out_dims, out_opt, &params, &quant);
+        r->opt_cycles = esp_cpu_get_cycle_count() - start;
+        break;
+    }
+    case NN_BENCH_DWCONV: {
+        dw_conv_params_t params = { .in_offset = 0, .out_offset = 0, .ch_mult = out_ch / s->in_ch,
+                                    .stride = { s->stride, s->stride }, .padding = { pad_wd, pad_ht },
+                                    .dilation = { 1, 1 }, .activation = { -128, 127 } };
+        int size = esp_nn_get_depthwise_conv_scratch_size(&in_dims, &filter_dims, &out_dims, &params);
+        if (size > 0) {
+            scratch = malloc(size + 16);
+            if (!scratch) { ret = ESP_ERR_NO_MEM; goto cleanup; }
+            esp_nn_set_depthwise_conv_scratch_buf((void *)(((uintptr_t)scratch + 15) & ~(uintptr_t)15));
+        }
+        start = esp_cpu_get_cycle_count();
+        esp_nn_depthwise_conv_s8_ansi(&in_dims, input, &filter_dims, filter, bias, &out_dims, out_ansi, &params, &quant);
+        r->ansi_cycles = esp_cpu_get_cycle_count() - start;
+        start = esp_cpu_get_cycle_count();
+        esp_nn_depthwise_conv_s8(&in_dims, input, &filter_dims, filter, bias, &out_dims, out_opt, &params, &quant);
+        r->opt_cycles = esp_cpu_get_cycle_count() - start;
+        break;
+    }
+    case NN_BENCH_FC:
+        start = esp_cpu_get_cycle_count();
+        esp_nn_fully_connected_s8_ansi(input, 0, s->in_ch, filter, 0, bias, out_ansi, out_ch,
+                                       0, shift[0], mult[0], -128, 127);
+        r->ansi_cycles = esp_cpu_get_cycle_count() - start;
+        start = esp_cpu_get_cycle_count();
+        esp_nn_fully_connected_s8(input, 0, s->in_ch, filter, 0, bias, out_opt, out_ch,
+                                  0, shift[0], mult[0], -128, 127);
+        r->opt_cycles = esp_cpu_get_cycle_count() - start;
+        break;
+    case NN_BENCH_SOFTMAX: {
+        int size = esp_nn_get_softmax_scratch_size(s->in_ch, s->height);
+        if (size > 0) {
+            scratch = malloc(size + 16);
+            if (!scratch) { ret = ESP_ERR_NO_MEM; goto cleanup; }
+            esp_nn_set_softmax_scratch_buf((void *)(((uintptr_t)scratch + 15) & ~(uintptr_t)15));
+        }
+        /* per-layer setup, done once at model load, so kept out of the timing */
+        esp_nn_prepare_softmax_s8(1 << 30, 22, -248);
+        start = esp_cpu_get_cycle_count();
+        esp_nn_softmax_s8_ansi(input, s->height, s->in_ch, 1 << 30, 22, -248, out_ansi);
+        r->ansi_cycles = esp_cpu_get_cycle_count() - start;
+        start = esp_cpu_get_cycle_count();
+        esp_nn_softmax_s8(input, s->height, s->in_ch, 1 << 30, 22, -248, out_opt);
+        r->opt_cycles = esp_cpu_get_cycle_count() - start;
+        break;
+    }
+    case NN_BENCH_MAXPOOL:
+        start = esp_cpu_get_cycle_count();
+        esp_nn_max_pool_s8_ansi(input, s->width, s->height, out_ansi, out_wd, out_ht, s->stride, s->stride,
+                                s->filter, s->filter, pad_wd, pad_ht, -128, 127, s->in_ch);
+        r->ansi_cycles = esp_cpu_get_cycle_count() - start;
+        start = esp_cpu_get_cycle_count();
+        esp_nn_max_pool_s8(input, s->width, s->height, out_opt, out_wd, out_ht, s->stride, s->stride,
+                           s->filter, s->filter, pad_wd, pad_ht, -128, 127, s->in_ch);
+        r->opt_cycles = esp_cpu_get_cycle_count() - start;
+        break;
+    case NN_BENCH_AVGPOOL:
+        start = esp_cpu_get_cycle_count();
+        esp_nn_avg_pool_s8_ansi(input, s->width, s->height, out_ansi, out_wd, out_ht, s->stride, s->stride,
+                                s->filter, s->filter, pad_wd, pad_ht, -128, 127, s->in_ch);
+        r->ansi_cycles = esp_cpu_get_cycle_count() - start;
+        start = esp_cpu_get_cycle_count();
+        esp_nn_avg_pool_s8(input, s->width, s->height, out_opt, out_wd, out_ht, s->stride, s->stride,
+                           s->filter, s->filter, pad_wd, pad_ht, -128, 127, s->in_ch);
+        r->opt_cycles = esp_cpu_get_cycle_count() - start;
+        break;
+    default:
+        break;
+    }
+
+    r->exact = memcmp(out_ansi, out_opt, out_size) == 0;
+
+cleanup:
+    /* Do not leave esp-nn pointing at freed scratch memory */
+    if (scratch) {
+        if (kernel == NN_BENCH_CONV) esp_nn_set_conv_scratch_buf(NULL);
+        else if (kernel == NN_BENCH_DWCONV) esp_nn_set_depthwise_conv_scratch_buf(NULL);
+        else if (kernel == NN_BENCH_SOFTMAX) esp_nn_set_softmax_scratch_buf(NULL);
+    }
+    free(input);
+    free(filter);
+    free(out_ansi);
+    free(out_opt);
+    free(bias);
+    free(shift);
+    free(mult);
+    free(scratch);
+    return ret;
+}
+
+esp_err_t nn_bench_run(nn_bench_kernel_t kernel, const nn_bench_shape_t *s,
+                       nn_bench_result_t *r) {
+    /* The classifier task runs esp-nn with its own scratch buffers */
+    nn_lock();
+    esp_err_t ret = nn_bench_case(kernel, s, r);
+    nn_unlock();
+    return ret;
+}
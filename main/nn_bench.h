@@ -0,0 +1,75 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+
+/**
+ * @brief esp-nn kernels available to the bench command
+ */
+typedef enum {
+    NN_BENCH_CONV = 0,
+    NN_BENCH_DWCONV,
+    NN_BENCH_FC,
+    NN_BENCH_SOFTMAX,
+    NN_BENCH_MAXPOOL,
+    NN_BENCH_AVGPOOL,
+    NN_BENCH_STREAM,
+    NN_BENCH_COUNT
+} nn_bench_kernel_t;
+
+/**
+ * @brief Kernel shape (NHWC input, square filter)
+ *
+ * fc uses in_ch as row length and out_ch as output channels; softmax uses
+ * in_ch as row width and height as row count. stream is a 1-D conv over
+ * width (height and pad ignored).
+ */
+typedef struct {
+    int width;
+    int height;
+    int in_ch;
+    int out_ch;
+    int filter;
+    int stride;
+    int pad;
+} nn_bench_shape_t;
+
+/**
+ * @brief Result of one ANSI vs optimized run
+ *
+ * For stream, ansi is the full-window esp_nn_conv_s8_ansi recompute and opt
+ * one streaming step (one new output column); exact compares the streamed
+ * output sequence against the full window.
+ */
+typedef struct {
+    uint32_t ansi_cycles;
+    uint32_t opt_cycles;
+    uint64_t ops;           /* multiply-accumulates (or element ops) per run */
+    bool exact;             /* optimized output identical to ANSI */
+} nn_bench_result_t;
+
+/**
+ * @brief Name of a kernel as typed on the console
+ */
+const char *nn_bench_name(nn_bench_kernel_t kernel);
+
+/**
+ * @brief Find a kernel by name
+ * @return Kernel, or NN_BENCH_COUNT if unknown
+ */
+nn_bench_kernel_t nn_bench_lookup(const char *name);
+
+/**
+ * @brief Fill a shape with the README reference case for a kernel
+ */
+void nn_bench_default_shape(nn_bench_kernel_t kernel, nn_bench_shape_t *shape);
+
+/**
+ * @brief Run a kernel once with the ANSI and once with the optimized version
+ *
+ * Inputs are pseudo-random; buffers are allocated for the run and freed.
+ *
+ * @return ESP_OK, ESP_ERR_INVALID_ARG for a bad shape, ESP_ERR_NO_MEM
+ */
+esp_err_t nn_bench_run(nn_bench_kernel_t kernel, const nn_bench_shape_t *shape,
+                       nn_bench_result_t *result);
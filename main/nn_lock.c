@@ -0,0 +1,22 @@
+#include "nn_lock.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+
+static SemaphoreHandle_t nn_mutex;
+static StaticSemaphore_t nn_mutex_buf;
+
+void nn_lock_init(void)
+{
+    /* Static storage: cannot fail, and runs before any task uses esp-nn */
+    nn_mutex = xSemaphoreCreateMutexStatic(&nn_mutex_buf);
+}
+
+void nn_lock(void)
+{
+    xSemaphoreTake(nn_mutex, portMAX_DELAY);
+}
+
+void nn_unlock(void)
+{
+    xSemaphoreGive(nn_mutex);
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+/**
+ * @brief Serialise use of esp-nn across tasks
+ *
+ * esp-nn keeps its conv and depthwise scratch pointers and the softmax exp
+ * table in globals, and the optimised kernels write into whatever was set
+ * last. Hold the lock from setting a scratch buffer until the last kernel
+ * using it returns, on every task that runs esp-nn.
+ */
+void nn_lock_init(void);
+
+/**
+ * @brief Take the esp-nn lock, waiting as long as needed
+ */
+void nn_lock(void);
+
+/**
+ * @brief Release the esp-nn lock
+ */
+void nn_unlock(void);
@@ -1,13 +1,42 @@
 #include "nvs.h"
 #include "nvs_flash.h"
-#include "adc.h"
 #include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include <string.h>
 
 static const char *TAG = "NVS";
 static nvs_handle_t nvs;
 
+/* Keys are spelled out at compile time, one per (parameter, channel) */
+_Static_assert(CH_MAX == 6, "update PARAM_KEYS for the new channel count");
+#define PARAM_KEYS(prefix) { prefix "0", prefix "1", prefix "2", prefix "3", prefix "4", prefix "5" }
+
+static const char *const param_keys[NVS_PARAM_COUNT][CH_MAX] = {
+    [NVS_PARAM_MIN]  = PARAM_KEYS("ch_min"),
+    [NVS_PARAM_MAX]  = PARAM_KEYS("ch_max"),
+    [NVS_PARAM_HYST] = PARAM_KEYS("ch_hyst"),
+    [NVS_PARAM_VAL]  = PARAM_KEYS("ch_val"),
+};
+
+static const int32_t param_defaults[NVS_PARAM_COUNT] = {
+    [NVS_PARAM_MIN]  = 0,
+    [NVS_PARAM_MAX]  = 4095,
+    [NVS_PARAM_HYST] = 10,
+    [NVS_PARAM_VAL]  = 0,
+};
+
+static int32_t param_cache[NVS_PARAM_COUNT][CH_MAX];
+static uint8_t param_dirty[NVS_PARAM_COUNT];    /* bit n = channel n */
+static portMUX_TYPE param_lock = portMUX_INITIALIZER_UNLOCKED;
+
+#define SETTINGS_KEY "settings"
+/* Only touched by the config task, which also flushes */
+static nvs_settings_t settings_cache;
+static bool settings_stored;
+static bool settings_dirty;
+
 /**
- * @brief Initialize NVS and open handle
+ * @brief Initialize NVS, open handle and fill the parameter cache
  */
 void nvs_init(void) {
     esp_err_t err = nvs_flash_init();
@@ -17,21 +46,88 @@ void nvs_init(void) {
     }
     ESP_ERROR_CHECK(err);
     ESP_ERROR_CHECK(nvs_open("adc", NVS_READWRITE, &nvs));
+
+    for(int p=0; p<NVS_PARAM_COUNT; p++) {
+        for(int ch=0; ch<CH_MAX; ch++) {
+            param_cache[p][ch] = nvs_param_read_raw(p, ch);
+        }
+    }
+
+    /* A blob of another size was written by a different layout, ignore it */
+    size_t len = sizeof(settings_cache);
+    settings_stored = nvs_get_blob(nvs, SETTINGS_KEY, &settings_cache, &len) == ESP_OK &&
+                      len == sizeof(settings_cache);
+}
+
+int32_t nvs_param_get(nvs_param_t param, int ch) {
+    if(!check_channel(ch)) return param_defaults[param];
+    return param_cache[param][ch];
 }
 
-void nvs_set_channel_i32(const char *prefix, int ch, int32_t val) {
+void nvs_param_set(nvs_param_t param, int ch, int32_t val) {
     if(!check_channel(ch)) return;
-    char key[16];
-    sprintf(key, "%s%d", prefix, ch);
-    nvs_set_i32(nvs, key, val);
-    nvs_commit(nvs);
+    portENTER_CRITICAL(&param_lock);
+    if(param_cache[param][ch] != val) {
+        param_cache[param][ch] = val;
+        param_dirty[param] |= 1 << ch;
+    }
+    portEXIT_CRITICAL(&param_lock);
+}
+
+esp_err_t nvs_param_flush(void) {
+    esp_err_t ret = ESP_OK;
+    bool written = false;
+
+    for(int p=0; p<NVS_PARAM_COUNT; p++) {
+        portENTER_CRITICAL(&param_lock);
+        uint8_t dirty = param_dirty[p];
+        param_dirty[p] = 0;
+        portEXIT_CRITICAL(&param_lock);
+
+        for(int ch=0; dirty; ch++, dirty >>= 1) {
+            if(!(dirty & 1)) continue;
+            esp_err_t err = nvs_set_i32(nvs, param_keys[p][ch], param_cache[p][ch]);
+            if(err != ESP_OK) {
+                ESP_LOGE(TAG, "Failed to write %s: %s", param_keys[p][ch], esp_err_to_name(err));
+                ret = err;
+            }
+            written = true;
+        }
+    }
+
+    if(settings_dirty) {
+        settings_dirty = false;
+        esp_err_t err = nvs_set_blob(nvs, SETTINGS_KEY, &settings_cache, sizeof(settings_cache));
+        if(err != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to write %s: %s", SETTINGS_KEY, esp_err_to_name(err));
+            ret = err;
+        }
+        written = true;
+    }
+
+    if(written) {
+        esp_err_t err = nvs_commit(nvs);
+        if(err != ESP_OK) ret = err;
+    }
+    return ret;
 }
 
-int32_t nvs_get_channel_i32(const char *prefix, int ch, int32_t def_val) {
-    if(!check_channel(ch)) return def_val;
-    char key[16];
-    sprintf(key, "%s%d", prefix, ch);
-    int32_t val = def_val;
-    nvs_get_i32(nvs, key, &val);
+int32_t nvs_param_read_raw(nvs_param_t param, int ch) {
+    int32_t val = param_defaults[param];
+    if(!check_channel(ch)) return val;
+    nvs_get_i32(nvs, param_keys[param][ch], &val);
     return val;
 }
+
+bool nvs_settings_get(nvs_settings_t *out) {
+    if(!settings_stored) return false;
+    *out = settings_cache;
+    return true;
+}
+
+void nvs_settings_set(const nvs_settings_t *settings) {
+    if(settings_stored && memcmp(&settings_cache, settings, sizeof(settings_cache)) == 0) return;
+    settings_cache = *settings;
+    settings_stored = true;
+    settings_dirty = true;
+}
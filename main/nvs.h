@@ -1,18 +1,74 @@
 #pragma once
 #include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "adc.h"
+#include "sched.h"
+#include "goertzel.h"
 
 /**
- * @brief Initialize NVS
+ * @brief Per-channel parameters persisted in NVS
+ */
+typedef enum {
+    NVS_PARAM_MIN = 0,  /* "ch_min<n>", scaling minimum */
+    NVS_PARAM_MAX,      /* "ch_max<n>", scaling maximum */
+    NVS_PARAM_HYST,     /* "ch_hyst<n>", hysteresis */
+    NVS_PARAM_VAL,      /* "ch_val<n>", last filtered value */
+    NVS_PARAM_COUNT
+} nvs_param_t;
+
+/**
+ * @brief Acquisition settings persisted as one blob ("settings")
+ *
+ * Cached like the parameters and written by the same nvs_param_flush(), so
+ * a configuration change lands in a single NVS commit.
+ */
+typedef struct {
+    sched_config_t sched;
+    int32_t block_len;
+    uint8_t tone_count[CH_MAX];
+    uint32_t tones[CH_MAX][GOERTZEL_MAX_TONES];
+} nvs_settings_t;
+
+/**
+ * @brief Initialize NVS and load every parameter into the cache
  */
 void nvs_init(void);
 
 /**
- * @brief Save int32 value for a specific channel
+ * @brief Read a cached parameter (O(1), no flash access)
+ * @return Cached value, or the parameter default if ch is invalid
+ */
+int32_t nvs_param_get(nvs_param_t param, int ch);
+
+/**
+ * @brief Update a cached parameter and mark it dirty if it changed
+ *
+ * Nothing is written to flash until nvs_param_flush().
+ */
+void nvs_param_set(nvs_param_t param, int ch, int32_t val);
+
+/**
+ * @brief Write every dirty parameter and the settings if dirty, commit once
+ */
+esp_err_t nvs_param_flush(void);
+
+/**
+ * @brief Read a parameter straight from flash, bypassing the cache
+ *
+ * For diagnostics and benchmarks only.
+ */
+int32_t nvs_param_read_raw(nvs_param_t param, int ch);
+
+/**
+ * @brief Read the cached settings
+ * @return false if none were ever stored (or stored by another layout)
  */
-void nvs_set_channel_i32(const char *prefix, int ch, int32_t val);
+bool nvs_settings_get(nvs_settings_t *out);
 
 /**
- * @brief Read int32 value for a specific channel
- * @return Stored value or def_val if not found
+ * @brief Update the cached settings and mark them dirty if they changed
+ *
+ * Nothing is written to flash until nvs_param_flush().
  */
-int32_t nvs_get_channel_i32(const char *prefix, int ch, int32_t def_val);
\ No newline at end of file
+void nvs_settings_set(const nvs_settings_t *settings);
@@ -0,0 +1,205 @@
+#include "pipeline.h"
+#include <stdio.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/stream_buffer.h"
+#include "freertos/semphr.h"
+#include "esp_log.h"
+
+static const char *TAG = "PIPE";
+
+static QueueHandle_t cfg_queue;
+/* Serialises producers, so free space seen by a batch stays free */
+static SemaphoreHandle_t cfg_post_lock;
+static StreamBufferHandle_t out_buf;
+static volatile uint32_t out_dropped;
+
+/* Private kinds: persist everything queued before it, and do nothing */
+#define CFG_MSG_COMMIT (PIPELINE_CFG_TONES + 1)
+#define CFG_MSG_PING   (PIPELINE_CFG_TONES + 2)
+
+/**
+ * @brief Stage the live schedule, block length and tones for the next flush
+ */
+static void settings_capture(void)
+{
+    nvs_settings_t st;
+    memset(&st, 0, sizeof(st));    /* padding too, the cache compares bytes */
+    sched_get_config(&st.sched);
+    st.block_len = goertzel_get_block_len();
+    for(int ch=0; ch<CH_MAX; ch++) {
+        st.tone_count[ch] = goertzel_tone_count(ch);
+        for(int t=0; t<st.tone_count[ch]; t++) {
+            st.tones[ch][t] = goertzel_tone_freq(ch, t);
+        }
+    }
+    nvs_settings_set(&st);
+}
+
+/**
+ * @brief Apply stored settings at boot, before adc_task starts
+ */
+static void settings_restore(void)
+{
+    nvs_settings_t st;
+    if(!nvs_settings_get(&st)) return;
+
+    bool ok = sched_set_config(&st.sched) && goertzel_set_block_len(st.block_len);
+    for(int ch=0; ch<CH_MAX; ch++) {
+        ok &= goertzel_set_tones(ch, st.tones[ch], st.tone_count[ch]);
+    }
+    if(!ok) ESP_LOGW(TAG, "Stored settings partly invalid, defaults kept for those");
+}
+
+/**
+ * @brief Apply one configuration change
+ */
+static void config_handle(const pipeline_cfg_t *msg)
+{
+    switch((int)msg->kind) {
+    case PIPELINE_CFG_PARAM:
+        nvs_param_set(msg->param, msg->ch, msg->val);
+        break;
+    case PIPELINE_CFG_SCHED:
+        if(!sched_set_config(&msg->sched)) ESP_LOGW(TAG, "Invalid schedule dropped");
+        break;
+    case PIPELINE_CFG_BLOCK_LEN:
+        if(!goertzel_set_block_len(msg->val)) ESP_LOGW(TAG, "Invalid block length dropped");
+        break;
+    case PIPELINE_CFG_TONES:
+        if(!goertzel_set_tones(msg->ch, msg->tones.freq_mhz, msg->tones.count)) {
+            ESP_LOGW(TAG, "Invalid tones for CH%d dropped", msg->ch);
+        }
+        break;
+    case CFG_MSG_COMMIT:
+        settings_capture();
+        nvs_param_flush();
+        break;
+    default:
+        break;
+    }
+}
+
+/**
+ * @brief Applies queued configuration and persists dirty parameters
+ *
+ * Schedule and tone changes take effect as they arrive. Parameters are
+ * cached as they arrive and written in one NVS commit when a commit
+ * message is received. Values updated by adc_task are flushed
+ * whenever the queue stays idle for PIPELINE_FLUSH_MS.
+ */
+static void config_task(void *arg)
+{
+    pipeline_cfg_t msg;
+
+    while(1) {
+        if(xQueueReceive(cfg_queue, &msg, pdMS_TO_TICKS(PIPELINE_FLUSH_MS)) != pdTRUE) {
+            nvs_param_flush();
+        } else {
+            config_handle(&msg);
+        }
+    }
+}
+
+/**
+ * @brief Drains buffered console output to stdout
+ */
+static void output_task(void *arg)
+{
+    char chunk[128];
+
+    while(1) {
+        size_t len = xStreamBufferReceive(out_buf, chunk, sizeof(chunk), portMAX_DELAY);
+        if(len > 0) {
+            fwrite(chunk, 1, len, stdout);
+            if(xStreamBufferBytesAvailable(out_buf) == 0) {
+                fflush(stdout);
+            }
+        }
+    }
+}
+
+void pipeline_init(void)
+{
+    cfg_queue = xQueueCreate(PIPELINE_CFG_QUEUE_LEN, sizeof(pipeline_cfg_t));
+    cfg_post_lock = xSemaphoreCreateMutex();
+    out_buf = xStreamBufferCreate(PIPELINE_OUT_BUF_SIZE, 1);
+    if(!cfg_queue || !cfg_post_lock || !out_buf) {
+        ESP_LOGE(TAG, "Failed to allocate pipeline queues");
+        return;
+    }
+
+    settings_restore();
+    xTaskCreate(config_task, "config_task", 3072, NULL, CONFIG_TASK_PRIORITY, NULL);
+    xTaskCreate(output_task, "output_task", 2048, NULL, OUTPUT_TASK_PRIORITY, NULL);
+}
+
+bool pipeline_post_config(nvs_param_t param, int ch, int32_t val)
+{
+    pipeline_cfg_t msg = { .kind = PIPELINE_CFG_PARAM, .param = param, .ch = ch, .val = val };
+    xSemaphoreTake(cfg_post_lock, portMAX_DELAY);
+    bool sent = xQueueSend(cfg_queue, &msg, 0) == pdTRUE;
+    xSemaphoreGive(cfg_post_lock);
+    return sent;
+}
+
+bool pipeline_post_config_batch(const pipeline_cfg_t *items, int n)
+{
+    bool sent = false;
+
+    xSemaphoreTake(cfg_post_lock, portMAX_DELAY);
+    /* config_task only ever frees space, so this check holds until we send */
+    if(uxQueueSpacesAvailable(cfg_queue) >= (UBaseType_t)n + 1) {
+        for(int i=0; i<n; i++) {
+            xQueueSend(cfg_queue, &items[i], 0);
+        }
+        pipeline_cfg_t commit = { .kind = CFG_MSG_COMMIT };
+        xQueueSend(cfg_queue, &commit, 0);
+        sent = true;
+    }
+    xSemaphoreGive(cfg_post_lock);
+    return sent;
+}
+
+size_t pipeline_write(const char *data, size_t len)
+{
+    /* Only the console task writes; it may wait, acquisition never does */
+    size_t sent = xStreamBufferSend(out_buf, data, len, pdMS_TO_TICKS(100));
+    if(sent < len) out_dropped += len - sent;
+    return sent;
+}
+
+bool pipeline_commit_config(void)
+{
+    pipeline_cfg_t msg = { .kind = CFG_MSG_COMMIT };
+    xSemaphoreTake(cfg_post_lock, portMAX_DELAY);
+    bool sent = xQueueSend(cfg_queue, &msg, 0) == pdTRUE;
+    xSemaphoreGive(cfg_post_lock);
+    return sent;
+}
+
+bool pipeline_ping_config(void)
+{
+    pipeline_cfg_t msg = { .kind = CFG_MSG_PING };
+    xSemaphoreTake(cfg_post_lock, portMAX_DELAY);
+    bool sent = xQueueSend(cfg_queue, &msg, 0) == pdTRUE;
+    xSemaphoreGive(cfg_post_lock);
+    return sent;
+}
+
+uint32_t pipeline_cfg_pending(void)
+{
+    return cfg_queue ? uxQueueMessagesWaiting(cfg_queue) : 0;
+}
+
+uint32_t pipeline_out_pending(void)
+{
+    return out_buf ? xStreamBufferBytesAvailable(out_buf) : 0;
+}
+
+uint32_t pipeline_out_dropped(void)
+{
+    return out_dropped;
+}
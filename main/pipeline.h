@@ -0,0 +1,129 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "nvs.h"
+#include "sched.h"
+#include "goertzel.h"
+
+/**
+ * @brief Task priorities, acquisition above everything console-related
+ */
+#define ADC_TASK_PRIORITY     5
+#define CLS_TASK_PRIORITY     3
+#define CONFIG_TASK_PRIORITY  2
+#define CLI_TASK_PRIORITY     1
+#define OUTPUT_TASK_PRIORITY  1
+
+/**
+ * @brief Depth of the configuration queue (messages)
+ */
+#define PIPELINE_CFG_QUEUE_LEN 32
+
+/**
+ * @brief Size of the console output buffer (bytes)
+ */
+#define PIPELINE_OUT_BUF_SIZE 4096
+
+/**
+ * @brief Idle interval after which the config task persists values
+ *        updated by adc_task
+ */
+#define PIPELINE_FLUSH_MS 1000
+
+/**
+ * @brief Create the queues and the config and output tasks
+ */
+void pipeline_init(void);
+
+/**
+ * @brief Queue a parameter change for the config task
+ *
+ * The config task applies it to the parameter cache right away and
+ * persists it on the next pipeline_commit_config(), so the caller never
+ * touches flash.
+ *
+ * @return false if the queue is full
+ */
+bool pipeline_post_config(nvs_param_t param, int ch, int32_t val);
+
+/**
+ * @brief Persist every change queued so far in one NVS commit
+ * @return false if the queue is full
+ */
+bool pipeline_commit_config(void);
+
+/**
+ * @brief What a configuration message changes
+ */
+typedef enum {
+    PIPELINE_CFG_PARAM = 0,  /*!< NVS parameter: param, ch, val */
+    PIPELINE_CFG_SCHED,      /*!< Acquisition schedule: sched */
+    PIPELINE_CFG_BLOCK_LEN,  /*!< Goertzel block length: val */
+    PIPELINE_CFG_TONES,      /*!< Every tone of channel ch: tones */
+} pipeline_cfg_kind_t;
+
+/**
+ * @brief One configuration change of a batch
+ *
+ * Everything the console changes at runtime goes through the config task,
+ * so adc_task state is only ever written from one place.
+ */
+typedef struct {
+    pipeline_cfg_kind_t kind;
+    nvs_param_t param;
+    int ch;
+    union {
+        int32_t val;
+        sched_config_t sched;
+        struct {
+            int count;
+            uint32_t freq_mhz[GOERTZEL_MAX_TONES];
+        } tones;
+    };
+} pipeline_cfg_t;
+
+/**
+ * @brief Queue a batch of changes followed by a commit, all or nothing
+ *
+ * Queue space for the whole batch is checked before anything is sent, so
+ * a full queue leaves the configuration untouched.
+ *
+ * @return false if the batch does not fit in the queue right now
+ */
+bool pipeline_post_config_batch(const pipeline_cfg_t *items, int n);
+
+/**
+ * @brief Queue a message the config task receives and ignores
+ *
+ * Exercises the queue and a config task wake without touching the
+ * configuration or flash, for load tests.
+ *
+ * @return false if the queue is full
+ */
+bool pipeline_ping_config(void);
+
+/**
+ * @brief Queue console output for asynchronous draining to the UART
+ *
+ * Waits up to 100 ms for space. Whatever still does not fit is dropped
+ * and added to pipeline_out_dropped().
+ *
+ * @return Number of bytes accepted
+ */
+size_t pipeline_write(const char *data, size_t len);
+
+/**
+ * @brief Configuration messages waiting to be applied
+ */
+uint32_t pipeline_cfg_pending(void);
+
+/**
+ * @brief Console output bytes waiting to be drained
+ */
+uint32_t pipeline_out_pending(void);
+
+/**
+ * @brief Console output bytes dropped because the buffer stayed full
+ */
+uint32_t pipeline_out_dropped(void);
@@ -0,0 +1,96 @@
+#include "quant.h"
+#include "nvs.h"
+#include <math.h>
+#include <stdlib.h>
+
+/* 0 <= x <= 4095, so x * mult + bias stays inside int32 while
+ * QUANT_X_MAX * |mult| + |bias| < 2^31 */
+#define QUANT_X_MAX 4095
+#define QUANT_SUM_LIMIT (1LL << 31)
+
+esp_err_t quant_init(quant_adapter_t *q, int channels, float scale, int32_t zero_point) {
+    if(channels < 1 || channels > CH_MAX || !(scale > 0.0f) ||
+       zero_point < -128 || zero_point > 127) return ESP_ERR_INVALID_ARG;
+
+    q->channels = channels;
+    q->scale = scale;
+    q->zero_point = zero_point;
+    for(int c=0; c<channels; c++) {
+        esp_err_t err = quant_set_channel(q, c, c, false, 0.0f, 1.0f);
+        if(err != ESP_OK) return err;
+    }
+    return ESP_OK;
+}
+
+esp_err_t quant_set_channel(quant_adapter_t *q, int c, int adc_ch, bool scaled,
+                            float mean, float std) {
+    if(c < 0 || c >= q->channels || !check_channel(adc_ch) || !(std > 0.0f))
+        return ESP_ERR_INVALID_ARG;
+
+    /* x' = lo + x * gain, the same map adc_task applies for scaling */
+    double lo = 0.0, gain = 1.0;
+    if(scaled) {
+        int32_t min_val = nvs_param_get(NVS_PARAM_MIN, adc_ch);
+        int32_t max_val = nvs_param_get(NVS_PARAM_MAX, adc_ch);
+        lo = min_val;
+        gain = (max_val > min_val) ? (double)(max_val - min_val) / 4095.0 : 0.0;
+    }
+
+    /* q = (x' - mean) / (std * scale) + zero_point, rounded half up */
+    double k = 1.0 / ((double)std * q->scale);
+    double mult = gain * k * (1 << QUANT_SHIFT);
+    double bias = ((lo - mean) * k + q->zero_point + 0.5) * (1 << QUANT_SHIFT);
+    /* Screen in floating point first so the 64-bit rounding below is defined */
+    if(!(fabs(mult) < QUANT_SUM_LIMIT) || !(fabs(bias) < QUANT_SUM_LIMIT))
+        return ESP_ERR_INVALID_ARG;
+    int64_t m = llround(mult);
+    int64_t b = (int64_t)floor(bias);
+    if(QUANT_X_MAX * llabs(m) + llabs(b) >= QUANT_SUM_LIMIT)
+        return ESP_ERR_INVALID_ARG;
+
+    q->adc_ch[c] = adc_ch;
+    q->mult[c] = (int32_t)m;
+    q->bias[c] = (int32_t)b;
+    return ESP_OK;
+}
+
+int32_t quant_input_offset(const quant_adapter_t *q) {
+    return -q->zero_point;
+}
+
+/**
+ * @brief Quantize one contiguous run into a strided channel column
+ */
+static inline int8_t *quant_run(int8_t *dst, int stride, const int16_t *src, int n,
+                                int32_t mult, int32_t bias) {
+    for(int i=0; i<n; i++) {
+        int32_t v = (src[i] * mult + bias) >> QUANT_SHIFT;
+        if(v < -128) v = -128;
+        if(v > 127) v = 127;
+        *dst = (int8_t)v;
+        dst += stride;
+    }
+    return dst;
+}
+
+int quant_fill(const quant_adapter_t *q, int8_t *dst, int width) {
+    const int stride = q->channels;
+
+    /* One snapshot for every channel, so all columns cover the same wakes */
+    uint32_t count = adc_buf_snapshot();
+
+    /* Channel-outer order keeps mult/bias in registers for the whole window
+     * and the ring runs contiguous, with no per-sample wrap check */
+    for(int c=0; c<stride; c++) {
+        const int16_t *run1, *run2;
+        int len1;
+        if(adc_peek_block(q->adc_ch[c], count, width, &run1, &len1, &run2) < 0) return -1;
+
+        int8_t *out = quant_run(dst + c, stride, run1, len1, q->mult[c], q->bias[c]);
+        quant_run(out, stride, run2, width - len1, q->mult[c], q->bias[c]);
+    }
+
+    /* Called outside adc_task, the ring may have moved on while reading */
+    if(!adc_window_intact(count, width)) return -1;
+    return width;
+}
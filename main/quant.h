@@ -0,0 +1,82 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "adc.h"
+
+/**
+ * @brief Fixed-point fraction bits of the per-channel affine map
+ */
+#define QUANT_SHIFT 16
+
+/**
+ * @brief ADC to int8 tensor adapter
+ *
+ * Tensor channel c is fed by ADC channel adc_ch[c] through
+ * q = clamp((x * mult[c] + bias[c]) >> QUANT_SHIFT, -128, 127), with the
+ * normalization, min/max scaling, tensor scale and zero point all folded
+ * into mult and bias when the channel is configured.
+ */
+typedef struct {
+    int channels;               /* tensor channels (C of NHWC) */
+    float scale;                /* tensor scale, real = scale * (q - zero_point) */
+    int32_t zero_point;         /* tensor zero point */
+    uint8_t adc_ch[CH_MAX];
+    int32_t mult[CH_MAX];
+    int32_t bias[CH_MAX];
+} quant_adapter_t;
+
+/**
+ * @brief Set up an adapter for a tensor's quantization parameters
+ *
+ * Tensor channel c starts mapped to ADC channel c, unnormalized raw counts.
+ *
+ * @param q Adapter
+ * @param channels Tensor channels (1..CH_MAX)
+ * @param scale Tensor input scale (> 0)
+ * @param zero_point Tensor input zero point (-128..127)
+ * @return ESP_OK, or ESP_ERR_INVALID_ARG
+ */
+esp_err_t quant_init(quant_adapter_t *q, int channels, float scale, int32_t zero_point);
+
+/**
+ * @brief Map a tensor channel to an ADC channel with optional normalization
+ *
+ * The real value fed to the model is (x - mean) / std, where x is the raw
+ * count, or when scaled is set, the count after the channel's current
+ * min/max scaling. Pass mean 0 and std 1 for no normalization. Rescaling
+ * a channel's min/max requires calling this again.
+ *
+ * @param q Adapter
+ * @param c Tensor channel
+ * @param adc_ch Source ADC channel
+ * @param scaled Quantize min/max scaled values instead of raw counts
+ * @param mean Normalization mean
+ * @param std Normalization standard deviation (> 0)
+ * @return ESP_OK, or ESP_ERR_INVALID_ARG if out of range or the folded
+ *         map would overflow 32-bit arithmetic
+ */
+esp_err_t quant_set_channel(quant_adapter_t *q, int c, int adc_ch, bool scaled,
+                            float mean, float std);
+
+/**
+ * @brief in_offset for conv_params_t / esp_nn_fully_connected_s8
+ */
+int32_t quant_input_offset(const quant_adapter_t *q);
+
+/**
+ * @brief Quantize the latest ADC window straight into a model input
+ *
+ * Writes an NHWC tensor of height 1, the given width and q->channels
+ * channels, oldest sample at w = 0, reading the acquisition ring in place.
+ * Every channel is read at the same ring position. Safe to call from any
+ * task: if adc_task overwrites part of the window meanwhile, the call fails.
+ *
+ * @param q Adapter
+ * @param dst Input arena, width * q->channels bytes
+ * @param width Window length in samples (< ADC_BUF_LEN, one slot is left
+ *              for the wake in progress)
+ * @return width on success, -1 if invalid, not enough samples acquired yet
+ *         or the window was overwritten while reading
+ */
+int quant_fill(const quant_adapter_t *q, int8_t *dst, int width);
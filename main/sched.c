@@ -0,0 +1,103 @@
+#include "sched.h"
+#include "adc.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+static sched_config_t config = {
+    .mode = SCHED_MODE_CONTINUOUS,
+    .interval_ms = 10000,
+    .burst_len = 16,
+};
+
+static sched_stats_t stats;
+static portMUX_TYPE stats_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static TaskHandle_t wake_task = NULL;
+
+bool sched_config_valid(const sched_config_t *cfg) {
+    if(cfg->mode == SCHED_MODE_CONTINUOUS) return true;
+    if(cfg->mode != SCHED_MODE_LOW_POWER) return false;
+    if(cfg->interval_ms < SCHED_MIN_INTERVAL_MS || cfg->interval_ms > SCHED_MAX_INTERVAL_MS)
+        return false;
+    if(cfg->burst_len < 1 || cfg->burst_len > SCHED_MAX_BURST)
+        return false;
+    return true;
+}
+
+bool sched_set_config(const sched_config_t *cfg) {
+    if(!sched_config_valid(cfg)) return false;
+    bool changed = cfg->mode != config.mode || cfg->interval_ms != config.interval_ms ||
+                   cfg->burst_len != config.burst_len;
+    config = *cfg;
+    if(changed && wake_task) xTaskNotifyGive(wake_task);
+    return true;
+}
+
+void sched_get_config(sched_config_t *cfg) {
+    *cfg = config;
+}
+
+void sched_set_wake_task(TaskHandle_t task) {
+    wake_task = task;
+}
+
+sched_mode_t sched_get_mode(void) {
+    return config.mode;
+}
+
+uint32_t sched_wake_period_ms(void) {
+    return config.mode == SCHED_MODE_LOW_POWER ? config.interval_ms : ADC_PERIOD_MS;
+}
+
+int sched_burst_len(void) {
+    return config.mode == SCHED_MODE_LOW_POWER ? config.burst_len : 1;
+}
+
+uint32_t sched_sample_rate_mhz(void) {
+    return 1000000 / sched_wake_period_ms();
+}
+
+void sched_record_wake(uint32_t active_us, uint32_t elapsed_us, bool scheduled) {
+    int32_t jitter = (int32_t)elapsed_us - (int32_t)(sched_wake_period_ms() * 1000);
+    if(jitter < 0) jitter = -jitter;
+
+    portENTER_CRITICAL(&stats_lock);
+    stats.wakes++;
+    stats.active_us += active_us;
+    stats.elapsed_us += elapsed_us;
+    /* The first wake after a reset or a schedule change has no meaningful interval */
+    if(stats.wakes > 1 && scheduled) {
+        if((uint32_t)jitter > stats.jitter_max_us) stats.jitter_max_us = jitter;
+        stats.jitter_sum_us += jitter;
+    }
+    portEXIT_CRITICAL(&stats_lock);
+}
+
+void sched_get_stats(sched_stats_t *out) {
+    portENTER_CRITICAL(&stats_lock);
+    *out = stats;
+    portEXIT_CRITICAL(&stats_lock);
+}
+
+void sched_reset_stats(void) {
+    portENTER_CRITICAL(&stats_lock);
+    stats.wakes = 0;
+    stats.active_us = 0;
+    stats.elapsed_us = 0;
+    stats.jitter_max_us = 0;
+    stats.jitter_sum_us = 0;
+    portEXIT_CRITICAL(&stats_lock);
+}
+
+uint32_t sched_active_ms_per_hour(const sched_stats_t *s) {
+    if(s->elapsed_us == 0) return 0;
+    return (uint32_t)((s->active_us * 3600000ULL) / s->elapsed_us);
+}
+
+uint32_t sched_model_active_ms_per_hour(const sched_config_t *cfg,
+                                        uint32_t wake_us, uint32_t sample_us) {
+    uint32_t period_ms = cfg->mode == SCHED_MODE_LOW_POWER ? cfg->interval_ms : ADC_PERIOD_MS;
+    uint32_t burst = cfg->mode == SCHED_MODE_LOW_POWER ? cfg->burst_len : 1;
+    uint64_t wakes_per_hour = 3600000ULL / period_ms;
+    return (uint32_t)((wakes_per_hour * (wake_us + (uint64_t)burst * sample_us)) / 1000);
+}
@@ -0,0 +1,127 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+/**
+ * @brief Acquisition mode
+ */
+typedef enum {
+    SCHED_MODE_CONTINUOUS = 0,  /* one sample per channel every ADC_PERIOD_MS */
+    SCHED_MODE_LOW_POWER        /* one burst per channel every interval_ms */
+} sched_mode_t;
+
+/**
+ * @brief Low-power interval range in milliseconds
+ */
+#define SCHED_MIN_INTERVAL_MS 1000
+#define SCHED_MAX_INTERVAL_MS 3600000
+
+/**
+ * @brief Maximum samples per channel in one low-power burst
+ */
+#define SCHED_MAX_BURST 64
+
+/**
+ * @brief Sampling schedule
+ */
+typedef struct {
+    sched_mode_t mode;
+    uint32_t interval_ms;   /* wake interval in low-power mode */
+    uint16_t burst_len;     /* samples per channel per wake in low-power mode */
+} sched_config_t;
+
+/**
+ * @brief Wake and active-time counters
+ */
+typedef struct {
+    uint32_t wakes;
+    uint64_t active_us;
+    uint64_t elapsed_us;
+    uint32_t jitter_max_us;     /* worst |wake interval - scheduled period| */
+    uint64_t jitter_sum_us;
+} sched_stats_t;
+
+/**
+ * @brief Check the interval and burst length of a schedule
+ */
+bool sched_config_valid(const sched_config_t *cfg);
+
+/**
+ * @brief Set the schedule, validating the interval and burst length
+ * @return true if accepted
+ */
+bool sched_set_config(const sched_config_t *cfg);
+
+/**
+ * @brief Current schedule
+ */
+void sched_get_config(sched_config_t *cfg);
+
+/**
+ * @brief Register the task that waits on the schedule
+ *
+ * A changed schedule sends it a task notification so a long low-power wait
+ * is cut short instead of running to the end of the old interval.
+ */
+void sched_set_wake_task(TaskHandle_t task);
+
+/**
+ * @brief Current acquisition mode
+ */
+sched_mode_t sched_get_mode(void);
+
+/**
+ * @brief Milliseconds until the next wake
+ */
+uint32_t sched_wake_period_ms(void);
+
+/**
+ * @brief Samples per channel to read on this wake
+ */
+int sched_burst_len(void);
+
+/**
+ * @brief Effective rate of processed samples in milli-hertz
+ */
+uint32_t sched_sample_rate_mhz(void);
+
+/**
+ * @brief Account one wake
+ *
+ * Also records wake jitter against the scheduled period.
+ *
+ * @param active_us Time spent awake processing
+ * @param elapsed_us Time since the previous wake
+ * @param scheduled false if a schedule change cut the wait short, the
+ *                  interval is then left out of the jitter
+ */
+void sched_record_wake(uint32_t active_us, uint32_t elapsed_us, bool scheduled);
+
+/**
+ * @brief Snapshot of the wake counters
+ */
+void sched_get_stats(sched_stats_t *stats);
+
+/**
+ * @brief Reset the wake counters
+ */
+void sched_reset_stats(void);
+
+/**
+ * @brief Active milliseconds per hour from measured counters
+ */
+uint32_t sched_active_ms_per_hour(const sched_stats_t *stats);
+
+/**
+ * @brief Modelled active milliseconds per hour for a schedule
+ *
+ * Energy proxy: wakes per hour times (wake overhead + samples * per-sample cost).
+ *
+ * @param cfg Schedule to model
+ * @param wake_us Fixed cost of one wake (task switch, bookkeeping)
+ * @param sample_us Cost of reading and processing one sample on all channels
+ */
+uint32_t sched_model_active_ms_per_hour(const sched_config_t *cfg,
+                                        uint32_t wake_us, uint32_t sample_us);
@@ -0,0 +1,89 @@
+#include "stream_conv.h"
+#include <stdlib.h>
+#include <string.h>
+
+esp_err_t stream_conv_init(stream_conv_t *s, int in_ch, int out_ch, int filter,
+                           const int8_t *filter_data, const int32_t *bias,
+                           const conv_params_t *params, const quant_data_t *quant)
+{
+    if (in_ch < 1 || out_ch < 1 || filter < 1 || params->stride.width < 1 ||
+        params->padding.width != 0 || params->padding.height != 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    memset(s, 0, sizeof(*s));
+    s->in_ch = in_ch;
+    s->out_ch = out_ch;
+    s->filter = filter;
+    s->stride = params->stride.width;
+    s->filter_data = filter_data;
+    s->bias = bias;
+    s->params = *params;
+    s->params.stride.height = 1;
+    /* Height is 1, so only the width dilation matters; 0 means undilated */
+    if (s->params.dilation.width < 1) s->params.dilation.width = 1;
+    s->params.dilation.height = 1;
+    s->span = (filter - 1) * s->params.dilation.width + 1;
+    s->quant = *quant;
+
+    s->hist = malloc(2 * s->span * in_ch);
+    if (s->hist == NULL) return ESP_ERR_NO_MEM;
+
+    /* One output column per call: a span-wide input and a 1-wide output */
+    data_dims_t in_dims = { .width = s->span, .height = 1, .channels = in_ch, .extra = 1 };
+    data_dims_t filter_dims = { .width = filter, .height = 1, .channels = in_ch, .extra = 1 };
+    data_dims_t out_dims = { .width = 1, .height = 1, .channels = out_ch, .extra = 1 };
+    int size = esp_nn_get_conv_scratch_size(&in_dims, &filter_dims, &out_dims, &s->params);
+    if (size > 0) {
+        s->alloc = malloc(size + 16);
+        if (s->alloc == NULL) {
+            stream_conv_free(s);
+            return ESP_ERR_NO_MEM;
+        }
+        s->scratch = (void *)(((uintptr_t)s->alloc + 15) & ~(uintptr_t)15);
+    }
+
+    stream_conv_reset(s);
+    return ESP_OK;
+}
+
+void stream_conv_free(stream_conv_t *s)
+{
+    free(s->hist);
+    free(s->alloc);
+    s->hist = NULL;
+    s->alloc = NULL;
+    s->scratch = NULL;
+}
+
+void stream_conv_reset(stream_conv_t *s)
+{
+    s->pos = 0;
+    s->seen = 0;
+}
+
+int stream_conv_push(stream_conv_t *s, const int8_t *col, int8_t *out)
+{
+    const int span = s->span;
+    const int in_ch = s->in_ch;
+
+    /* Write the column at its slot and span slots later, so slots
+     * pos..pos+span-1 always hold the last span columns in order */
+    memcpy(s->hist + s->pos * in_ch, col, in_ch);
+    memcpy(s->hist + (s->pos + span) * in_ch, col, in_ch);
+    if (++s->pos == span) s->pos = 0;
+
+    uint32_t seen = ++s->seen;
+    if (seen < (uint32_t)span || (seen - span) % s->stride != 0) return 0;
+
+    data_dims_t in_dims = { .width = span, .height = 1, .channels = in_ch, .extra = 1 };
+    data_dims_t filter_dims = { .width = s->filter, .height = 1, .channels = in_ch, .extra = 1 };
+    data_dims_t out_dims = { .width = 1, .height = 1, .channels = s->out_ch, .extra = 1 };
+
+    /* Scratch is global to esp-nn and shared with other layers, the caller
+     * holds nn_lock() */
+    if (s->scratch) esp_nn_set_conv_scratch_buf(s->scratch);
+    esp_nn_conv_s8(&in_dims, s->hist + s->pos * in_ch, &filter_dims, s->filter_data, s->bias,
+                   &out_dims, out, &s->params, &s->quant);
+    return 1;
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include <stdint.h>
+#include "esp_err.h"
+#include "esp_nn.h"
+
+/**
+ * @brief Streaming 1-D convolution layer (height 1, VALID padding)
+ *
+ * Keeps the last (filter - 1) * dilation + 1 input columns in a ring
+ * stored twice over, so the receptive field of the next output is always
+ * one contiguous NHWC run and each pushed column costs at most one output
+ * column of work. The output sequence is bit-exact with esp_nn_conv_s8_ansi
+ * run over the whole window from the first pushed column.
+ */
+typedef struct {
+    int in_ch;
+    int out_ch;
+    int filter;
+    int stride;
+    int span;                       /* input columns one output depends on */
+    const int8_t *filter_data;      /* [out_ch][1][filter][in_ch] */
+    const int32_t *bias;
+    conv_params_t params;
+    quant_data_t quant;
+    int8_t *hist;                   /* 2 * span columns of in_ch */
+    void *scratch;                  /* esp-nn conv scratch, NULL if none needed */
+    void *alloc;
+    int pos;                        /* oldest column slot in hist */
+    uint32_t seen;                  /* columns pushed since reset */
+} stream_conv_t;
+
+/**
+ * @brief Set up a streaming layer
+ *
+ * params padding must be zero; its stride width is used as the layer
+ * stride and its dilation width (0 taken as 1) spaces the filter taps.
+ * filter_data, bias and quant arrays are referenced, not copied.
+ *
+ * @return ESP_OK, ESP_ERR_INVALID_ARG or ESP_ERR_NO_MEM
+ */
+esp_err_t stream_conv_init(stream_conv_t *s, int in_ch, int out_ch, int filter,
+                           const int8_t *filter_data, const int32_t *bias,
+                           const conv_params_t *params, const quant_data_t *quant);
+
+/**
+ * @brief Release the history and scratch buffers
+ */
+void stream_conv_free(stream_conv_t *s);
+
+/**
+ * @brief Forget all pushed columns
+ */
+void stream_conv_reset(stream_conv_t *s);
+
+/**
+ * @brief Push one input column, producing an output column when one is due
+ *
+ * Sets the esp-nn conv scratch buffer and runs the kernel, so the caller
+ * must hold nn_lock() around it.
+ * @param s Layer
+ * @param col in_ch input values
+ * @param out out_ch output values, written only when 1 is returned
+ * @return 1 if an output column was written, 0 otherwise
+ */
+int stream_conv_push(stream_conv_t *s, const int8_t *col, int8_t *out);
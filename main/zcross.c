@@ -0,0 +1,86 @@
+#include "zcross.h"
+#include "adc.h"
+
+/* Centre tracking: centre_q8 += (x*256 - centre_q8) >> ZC_CENTRE_SHIFT */
+#define ZC_CENTRE_SHIFT 8
+
+static zc_state_t zc[CH_MAX];
+
+/**
+ * @brief Interpolated crossing time of the centre between samples n-1 and n
+ */
+static inline uint32_t zc_cross_time(const zc_state_t *s, int32_t x, int32_t centre)
+{
+    int32_t dy = x - s->prev;
+    uint32_t frac = dy ? (uint32_t)(((int64_t)(centre - s->prev) << 8) / dy) : 0;
+    return ((s->n - 1) << 8) + frac;
+}
+
+bool zcross_state_update(zc_state_t *s, int16_t sample, zc_result_t *out)
+{
+    int32_t x = (int32_t)sample << 8;
+    bool updated = false;
+
+    if (!s->primed) {
+        s->centre_q8 = x;
+        s->prev = x;
+        s->primed = true;
+        s->n = 1;
+        return false;
+    }
+
+    s->centre_q8 += (x - s->centre_q8) >> ZC_CENTRE_SHIFT;
+    int32_t c = s->centre_q8;
+
+    if (s->prev < c && x >= c) {
+        s->up_q8 = zc_cross_time(s, x, c);
+    } else if (s->prev >= c && x < c) {
+        s->down_q8 = zc_cross_time(s, x, c);
+    }
+
+    if (!s->high && x > c + (ZC_HYST << 8)) {
+        s->high = true;
+        if (s->have_rise) {
+            out->period_q8 = s->up_q8 - s->rise_q8;
+            uint32_t high = s->fall_q8 - s->rise_q8;
+            out->high_q8 = (high < out->period_q8) ? high : 0;
+            updated = true;
+        }
+        s->rise_q8 = s->up_q8;
+        s->have_rise = true;
+        s->last_edge = s->n;
+    } else if (s->high && x < c - (ZC_HYST << 8)) {
+        s->high = false;
+        s->fall_q8 = s->down_q8;
+        s->last_edge = s->n;
+    } else if (s->have_rise && s->n - s->last_edge > ZC_TIMEOUT_SAMPLES) {
+        s->have_rise = false;
+        out->period_q8 = 0;
+        out->high_q8 = 0;
+        updated = true;
+    }
+
+    s->prev = x;
+    s->n++;
+    return updated;
+}
+
+bool zcross_update(int ch, int16_t sample, zc_result_t *out)
+{
+    return zcross_state_update(&zc[ch], sample, out);
+}
+
+bool zcross_update_block(int ch, const int16_t *samples, int n, zc_result_t *out)
+{
+    bool updated = false;
+    for (int i = 0; i < n; i++) {
+        updated |= zcross_update(ch, samples[i], out);
+    }
+    return updated;
+}
+
+uint32_t zcross_freq_mhz(uint32_t period_q8, uint32_t rate_mhz)
+{
+    if (period_q8 == 0) return 0;
+    return (uint32_t)(((uint64_t)rate_mhz << 8) / period_q8);
+}
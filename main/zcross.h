@@ -0,0 +1,75 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Hysteresis band around the tracked centre level, in ADC counts
+ */
+#define ZC_HYST 20
+
+/**
+ * @brief Samples without a crossing before the estimate is dropped
+ */
+#define ZC_TIMEOUT_SAMPLES 4096
+
+/**
+ * @brief Result of the zero-crossing estimator
+ */
+typedef struct {
+    uint32_t period_q8;     /* period in samples, Q24.8 (0 = no signal) */
+    uint32_t high_q8;       /* time above centre within the period, Q24.8 */
+} zc_result_t;
+
+/**
+ * @brief Estimator state
+ *
+ * Each channel owns one, updated by adc_task. A zero-initialised state of
+ * the caller's own can be fed with zcross_state_update() without touching
+ * the channel estimators.
+ */
+typedef struct {
+    int32_t centre_q8;
+    int32_t prev;           /* previous sample, Q8 */
+    uint32_t n;             /* sample counter */
+    uint32_t up_q8;         /* last upward centre crossing */
+    uint32_t down_q8;       /* last downward centre crossing */
+    uint32_t rise_q8;       /* last confirmed rising edge */
+    uint32_t fall_q8;       /* last confirmed falling edge */
+    uint32_t last_edge;     /* sample index of last confirmed edge */
+    bool high;
+    bool have_rise;
+    bool primed;
+} zc_state_t;
+
+/**
+ * @brief Feed one raw sample to an estimator state
+ * @return true if out was updated
+ */
+bool zcross_state_update(zc_state_t *s, int16_t sample, zc_result_t *out);
+
+/**
+ * @brief Feed one raw sample to a channel's estimator
+ *
+ * Tracks the signal centre with a slow average, detects crossings with a
+ * hysteresis band of ZC_HYST and places them by linear interpolation
+ * between the two samples straddling the centre.
+ *
+ * @param ch Channel index
+ * @param sample Raw ADC sample
+ * @param out Updated when a full period completes or the signal times out
+ * @return true if out was updated
+ */
+bool zcross_update(int ch, int16_t sample, zc_result_t *out);
+
+/**
+ * @brief Feed a block of samples (burst acquisition)
+ * @return true if out was updated by any sample of the block
+ */
+bool zcross_update_block(int ch, const int16_t *samples, int n, zc_result_t *out);
+
+/**
+ * @brief Convert a period to frequency in milli-hertz
+ * @param period_q8 Period in samples, Q24.8
+ * @param rate_mhz Sample rate in milli-hertz
+ */
+uint32_t zcross_freq_mhz(uint32_t period_q8, uint32_t rate_mhz);